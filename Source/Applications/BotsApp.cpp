@@ -0,0 +1,698 @@
+#include "Common.h"
+#include "Log.h"
+#include "Exception.h"
+#include "Timer.h"
+#include "NetBuffer.h"
+#include "NetMessages.h"
+#include "NetCompression.h"
+#include "IniFile.h"
+#include "StringUtils.h"
+#include "zlib.h"
+#include <algorithm>
+#include <atomic>
+
+#ifndef FO_WINDOWS
+# include <fcntl.h>
+#endif
+
+// Headless load generator
+// Bots connect to server, register, log in, walk, chat and ping it
+// Network code follows FOClient, layouts of sent messages shared with it through NetMessages
+// Options (config or command line):
+//  BotsHost = 127.0.0.1, BotsPort = Port
+//  BotsCount = 100, BotsThreads = 4, BotsConnectRate = 50 (connections per second)
+//  BotsNamePrefix = Bot, BotsPassword = bot, BotsLanguage = russ, BotsRegister = 1
+//  BotsMovePeriod = 1000, BotsChatPeriod = 10000, BotsPingPeriod = 1000 (milliseconds, 0 - disabled)
+//  BotsReportPeriod = 10, BotsDuration = 0 (seconds, 0 - work until process killed)
+//  BotsLzCompression = 0 (request fast codec instead of zlib, see NetLzCompression)
+// Server must accept many registrations from one ip, set RegistrationTimeout = 0 on it
+
+#define BOT_STATE_OFFLINE      ( 0 )
+#define BOT_STATE_REGISTER     ( 1 )
+#define BOT_STATE_LOGIN        ( 2 )
+#define BOT_STATE_GAME         ( 3 )
+#define BOT_RECONNECT_TIME     ( 5000 )
+#define BOT_RECEIVE_BUF_SIZE   ( 0x10000 )
+
+struct BotsOptions
+{
+    string Host;
+    ushort Port;
+    uint   Count;
+    uint   Threads;
+    uint   ConnectRate;
+    string NamePrefix;
+    string Password;
+    uint   Language;
+    bool   Register;
+    uint   MovePeriod;
+    uint   ChatPeriod;
+    uint   PingPeriod;
+    bool   LzCompression;
+};
+
+struct BotsStatistics
+{
+    uint64  BytesSend;
+    uint64  BytesReceive;
+    uint64  BytesRealReceive;
+    uint64  MessagesReceive;
+    uint    Logins;
+    uint    Disconnects;
+    UIntVec Pings;
+
+    void Clear()
+    {
+        BytesSend = BytesReceive = BytesRealReceive = 0;
+        MessagesReceive = 0;
+        Logins = Disconnects = 0;
+        Pings.clear();
+    }
+
+    void Append( BotsStatistics& other )
+    {
+        BytesSend += other.BytesSend;
+        BytesReceive += other.BytesReceive;
+        BytesRealReceive += other.BytesRealReceive;
+        MessagesReceive += other.MessagesReceive;
+        Logins += other.Logins;
+        Disconnects += other.Disconnects;
+        Pings.insert( Pings.end(), other.Pings.begin(), other.Pings.end() );
+    }
+};
+
+static BotsOptions    Options;
+static BotsStatistics Statistics;
+static Mutex          StatisticsLocker;
+static uint           BotsInGame;
+static std::atomic< bool > BotsQuit;
+
+class Bot
+{
+private:
+    string        name;
+    int           state;
+    SOCKET        sock;
+    NetBuffer     bin;
+    NetBuffer     bout;
+    z_stream      zStream;
+    bool          zStreamOk;
+    NetLzDecoder* lzDecoder;
+    bool          registered;
+    uint          crId;
+    ushort        hexX;
+    ushort        hexY;
+    int           stepSign;
+    uint          connectTick;
+    uint          moveTick;
+    uint          chatTick;
+    uint          pingTick;
+    uint          pingSendTick;
+
+    bool NetConnect();
+    void NetDisconnect();
+    bool NetInput( BotsStatistics& stats );
+    bool NetOutput( BotsStatistics& stats );
+    void NetProcess( BotsStatistics& stats );
+
+    void Net_SendCreatePlayer();
+    void Net_SendLogIn();
+    void Net_SendLoadMapOk();
+    void Net_SendMove();
+    void Net_SendText( const string& text );
+    void Net_SendPing( uchar ping );
+
+    void Net_OnLoginSuccess( uint msg_begin );
+    void Net_OnAddCritter( uint msg_begin, bool is_npc );
+    void Net_OnCritterXY();
+    void Net_OnPing( BotsStatistics& stats );
+
+public:
+    Bot( uint bot_index, uint start_tick );
+    ~Bot();
+
+    void Process( BotsStatistics& stats );
+};
+
+Bot::Bot( uint bot_index, uint start_tick )
+{
+    name = _str( "{}{}", Options.NamePrefix, bot_index );
+    state = BOT_STATE_OFFLINE;
+    sock = INVALID_SOCKET;
+    zStreamOk = false;
+    lzDecoder = nullptr;
+    registered = !Options.Register;
+    crId = 0;
+    hexX = 0;
+    hexY = 0;
+    stepSign = 1;
+    connectTick = start_tick;
+    moveTick = 0;
+    chatTick = 0;
+    pingTick = 0;
+    pingSendTick = 0;
+}
+
+Bot::~Bot()
+{
+    NetDisconnect();
+}
+
+void Bot::Process( BotsStatistics& stats )
+{
+    uint tick = Timer::FastTick();
+
+    if( state == BOT_STATE_OFFLINE )
+    {
+        if( tick < connectTick )
+            return;
+
+        connectTick = tick + BOT_RECONNECT_TIME;
+        if( !NetConnect() )
+            return;
+
+        if( !registered )
+        {
+            Net_SendCreatePlayer();
+            state = BOT_STATE_REGISTER;
+        }
+        else
+        {
+            Net_SendLogIn();
+            state = BOT_STATE_LOGIN;
+        }
+    }
+
+    if( !NetInput( stats ) )
+    {
+        // Server closes connection after registration attempt, successful or not
+        if( state == BOT_STATE_REGISTER )
+        {
+            registered = true;
+            connectTick = tick;
+        }
+        else
+        {
+            stats.Disconnects++;
+        }
+        NetDisconnect();
+        return;
+    }
+
+    NetProcess( stats );
+
+    if( state == BOT_STATE_GAME )
+    {
+        if( Options.MovePeriod && tick >= moveTick )
+        {
+            moveTick = tick + Options.MovePeriod;
+            Net_SendMove();
+        }
+        if( Options.ChatPeriod && tick >= chatTick )
+        {
+            chatTick = tick + Options.ChatPeriod;
+            Net_SendText( _str( "Hello from {}, tick {}.", name, tick ) );
+        }
+        if( Options.PingPeriod && tick >= pingTick && !pingSendTick )
+        {
+            pingTick = tick + Options.PingPeriod;
+            pingSendTick = (uint) Timer::AccurateTick();
+            Net_SendPing( PING_PING );
+        }
+    }
+
+    if( !NetOutput( stats ) )
+    {
+        stats.Disconnects++;
+        NetDisconnect();
+    }
+}
+
+bool Bot::NetConnect()
+{
+    zStream.zalloc = Z_NULL;
+    zStream.zfree = Z_NULL;
+    zStream.opaque = Z_NULL;
+    zStream.next_in = Z_NULL;
+    zStream.avail_in = 0;
+    RUNTIME_ASSERT( inflateInit( &zStream ) == Z_OK );
+    zStreamOk = true;
+
+    sockaddr_in saddr;
+    memzero( &saddr, sizeof( saddr ) );
+    saddr.sin_family = AF_INET;
+    saddr.sin_port = htons( Options.Port );
+    saddr.sin_addr.s_addr = inet_addr( Options.Host.c_str() );
+
+    sock = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if( sock == INVALID_SOCKET )
+    {
+        WriteLog( "Bot '{}' can't create socket, error '{}'.\n", name, ERRORSTR );
+        NetDisconnect();
+        return false;
+    }
+
+    const int opt = 1;
+    setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, (char*) &opt, sizeof( opt ) );
+
+    // Loopback connection established immediately, after it work in non blocking mode
+    if( connect( sock, (sockaddr*) &saddr, sizeof( saddr ) ) == SOCKET_ERROR )
+    {
+        WriteLog( "Bot '{}' can't connect to server, error '{}'.\n", name, ERRORSTR );
+        NetDisconnect();
+        return false;
+    }
+
+    #ifdef FO_WINDOWS
+    unsigned long mode = 1;
+    ioctlsocket( sock, FIONBIO, &mode );
+    #else
+    fcntl( sock, F_SETFL, fcntl( sock, F_GETFL, 0 ) | O_NONBLOCK );
+    #endif
+
+    // Codec request goes before any other message
+    if( Options.LzCompression )
+    {
+        lzDecoder = new NetLzDecoder();
+        NetMessages::WriteCompression( bout, NET_COMPRESSION_LZ );
+    }
+
+    return true;
+}
+
+void Bot::NetDisconnect()
+{
+    if( state == BOT_STATE_GAME )
+    {
+        SCOPE_LOCK( StatisticsLocker );
+        BotsInGame--;
+    }
+    state = BOT_STATE_OFFLINE;
+
+    if( sock != INVALID_SOCKET )
+        closesocket( sock );
+    sock = INVALID_SOCKET;
+    if( zStreamOk )
+        inflateEnd( &zStream );
+    zStreamOk = false;
+    SAFEDEL( lzDecoder );
+
+    crId = 0;
+    pingSendTick = 0;
+    bin.Reset();
+    bout.Reset();
+    bin.SetEncryptKey( 0 );
+    bout.SetEncryptKey( 0 );
+    bin.SetError( false );
+    bout.SetError( false );
+}
+
+bool Bot::NetInput( BotsStatistics& stats )
+{
+    // Shared by bots of worker
+    static THREAD uchar comBuf[ BOT_RECEIVE_BUF_SIZE ];
+
+    while( true )
+    {
+        #ifdef FO_WINDOWS
+        int len = recv( sock, (char*) comBuf, sizeof( comBuf ), 0 );
+        if( len == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK )
+            return true;
+        #else
+        int len = (int) recv( sock, comBuf, sizeof( comBuf ), 0 );
+        if( len == SOCKET_ERROR && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+            return true;
+        #endif
+        if( len <= 0 )
+            return false;
+
+        bin.Refresh();
+        uint old_pos = bin.GetEndPos();
+
+        if( lzDecoder )
+        {
+            if( !lzDecoder->Decompress( comBuf, (uint) len, bin ) )
+            {
+                WriteLog( "Bot '{}' receive invalid compressed data.\n", name );
+                return false;
+            }
+        }
+
+        zStream.next_in = comBuf;
+        zStream.avail_in = ( lzDecoder ? 0 : (uint) len );
+        while( zStream.avail_in )
+        {
+            if( bin.GetEndPos() == bin.GetLen() )
+                bin.GrowBuf( NetBuffer::DefaultBufSize );
+
+            zStream.next_out = bin.GetData() + bin.GetEndPos();
+            zStream.avail_out = bin.GetLen() - bin.GetEndPos();
+            if( inflate( &zStream, Z_SYNC_FLUSH ) != Z_OK )
+            {
+                WriteLog( "Bot '{}' receive invalid compressed data.\n", name );
+                return false;
+            }
+            bin.SetEndPos( (uint) ( zStream.next_out - bin.GetData() ) );
+        }
+
+        stats.BytesReceive += len;
+        stats.BytesRealReceive += bin.GetEndPos() - old_pos;
+    }
+}
+
+bool Bot::NetOutput( BotsStatistics& stats )
+{
+    if( sock == INVALID_SOCKET || bout.IsEmpty() )
+        return true;
+
+    uint tosend = bout.GetEndPos();
+    uint sendpos = 0;
+    while( sendpos < tosend )
+    {
+        #ifdef FO_WINDOWS
+        int len = send( sock, (char*) bout.GetData() + sendpos, tosend - sendpos, 0 );
+        if( len == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK )
+        #else
+        int len = (int) send( sock, bout.GetData() + sendpos, tosend - sendpos, 0 );
+        if( len == SOCKET_ERROR && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+        #endif
+        {
+            Thread::Sleep( 0 );
+            continue;
+        }
+        if( len <= 0 )
+            return false;
+
+        sendpos += len;
+        stats.BytesSend += len;
+    }
+
+    bout.Reset();
+    return true;
+}
+
+void Bot::NetProcess( BotsStatistics& stats )
+{
+    while( state != BOT_STATE_OFFLINE && bin.NeedProcess() )
+    {
+        uint msg_begin = bin.GetCurPos();
+        uint msg = 0;
+        bin >> msg;
+        stats.MessagesReceive++;
+
+        switch( msg )
+        {
+        case NETMSG_REGISTER_SUCCESS:
+            registered = true;
+            break;
+        case NETMSG_WRONG_NET_PROTO:
+            WriteLog( "Bot '{}' has wrong network protocol.\n", name );
+            NetDisconnect();
+            return;
+        case NETMSG_LOGIN_SUCCESS:
+            Net_OnLoginSuccess( msg_begin );
+            break;
+        case NETMSG_LOADMAP:
+            bin.SkipMsg( msg );
+            Net_SendLoadMapOk();
+            break;
+        case NETMSG_ADD_PLAYER:
+            Net_OnAddCritter( msg_begin, false );
+            break;
+        case NETMSG_CRITTER_XY:
+            Net_OnCritterXY();
+            break;
+        case NETMSG_END_PARSE_TO_GAME:
+            if( state == BOT_STATE_LOGIN && crId )
+            {
+                state = BOT_STATE_GAME;
+                stats.Logins++;
+                SCOPE_LOCK( StatisticsLocker );
+                BotsInGame++;
+            }
+            break;
+        case NETMSG_PING:
+            Net_OnPing( stats );
+            break;
+        default:
+            bin.SkipMsg( msg );
+            break;
+        }
+
+        if( bin.IsError() )
+        {
+            WriteLog( "Bot '{}' receive wrong network data.\n", name );
+            NetDisconnect();
+            return;
+        }
+    }
+}
+
+void Bot::Net_SendCreatePlayer()
+{
+    NetMessages::WriteCreatePlayer( bout, bin, name, Options.Password );
+}
+
+void Bot::Net_SendLogIn()
+{
+    NetMessages::WriteLogIn( bout, bin, name, Options.Password, Options.Language );
+}
+
+void Bot::Net_SendLoadMapOk()
+{
+    NetMessages::WriteLoadMapOk( bout );
+}
+
+void Bot::Net_SendMove()
+{
+    // Step back and forth by x, these hexes are neighbors in both square and hexagonal geometry
+    ushort to_hx = (ushort) ( hexX + stepSign );
+    stepSign = -stepSign;
+
+    NetMessages::WriteMove( bout, false, 0, to_hx, hexY );
+    hexX = to_hx;
+}
+
+void Bot::Net_SendText( const string& text )
+{
+    NetMessages::WriteText( bout, text, SAY_NORM );
+}
+
+void Bot::Net_SendPing( uchar ping )
+{
+    NetMessages::WritePing( bout, ping );
+}
+
+void Bot::Net_OnLoginSuccess( uint msg_begin )
+{
+    uint msg_len;
+    uint bin_seed, bout_seed;
+    bin >> msg_len;
+    bin >> bin_seed;
+    bin >> bout_seed;
+
+    // Skip global properties before keys changing
+    bin.MoveReadPos( (int) ( msg_begin + msg_len - bin.GetCurPos() ) );
+
+    bout.SetEncryptKey( bin_seed );
+    bin.SetEncryptKey( bout_seed );
+}
+
+void Bot::Net_OnAddCritter( uint msg_begin, bool is_npc )
+{
+    uint   msg_len;
+    uint   crid;
+    ushort hx, hy;
+    uchar  dir;
+    int    cond;
+    uint   anims[ 6 ];
+    uint   flags;
+    bin >> msg_len;
+    bin >> crid;
+    bin >> hx;
+    bin >> hy;
+    bin >> dir;
+    bin >> cond;
+    bin.Pop( anims, sizeof( anims ) );
+    bin >> flags;
+    bin.MoveReadPos( (int) ( msg_begin + msg_len - bin.GetCurPos() ) );
+
+    if( !is_npc && FLAG( flags, FCRIT_CHOSEN ) )
+    {
+        crId = crid;
+        hexX = hx;
+        hexY = hy;
+    }
+}
+
+void Bot::Net_OnCritterXY()
+{
+    uint   crid;
+    ushort hx, hy;
+    uchar  dir;
+    bin >> crid;
+    bin >> hx;
+    bin >> hy;
+    bin >> dir;
+
+    if( crid == crId )
+    {
+        hexX = hx;
+        hexY = hy;
+    }
+}
+
+void Bot::Net_OnPing( BotsStatistics& stats )
+{
+    uchar ping;
+    bin >> ping;
+
+    if( ping == PING_CLIENT )
+    {
+        Net_SendPing( PING_CLIENT );
+    }
+    else if( ping == PING_PING && pingSendTick )
+    {
+        // Server answers in logic thread, so time include cycle latency
+        stats.Pings.push_back( (uint) Timer::AccurateTick() - pingSendTick );
+        pingSendTick = 0;
+    }
+}
+
+/************************************************************************/
+/* Workers                                                              */
+/************************************************************************/
+
+static void BotsWork( void* data )
+{
+    vector< Bot* >& bots = *(vector< Bot* >*) data;
+
+    BotsStatistics  stats;
+    stats.Clear();
+    uint            flush_tick = Timer::FastTick();
+    while( !BotsQuit )
+    {
+        for( Bot* bot : bots )
+            bot->Process( stats );
+
+        // Merge local counters not often to not contend with other workers
+        uint tick = Timer::FastTick();
+        if( tick - flush_tick >= 100 )
+        {
+            flush_tick = tick;
+            SCOPE_LOCK( StatisticsLocker );
+            Statistics.Append( stats );
+            stats.Clear();
+        }
+
+        Thread::Sleep( 1 );
+    }
+
+    for( Bot* bot : bots )
+        delete bot;
+}
+
+static uint GetPercentile( UIntVec& sorted_values, uint percent )
+{
+    if( sorted_values.empty() )
+        return 0;
+    return sorted_values[ MIN( (uint) sorted_values.size() * percent / 100, (uint) sorted_values.size() - 1 ) ];
+}
+
+static void Report( double seconds )
+{
+    BotsStatistics stats;
+    uint           in_game;
+    {
+        SCOPE_LOCK( StatisticsLocker );
+        stats = Statistics;
+        Statistics.Clear();
+        in_game = BotsInGame;
+    }
+
+    std::sort( stats.Pings.begin(), stats.Pings.end() );
+    seconds = MAX( seconds, 0.001 );
+
+    WriteLog( "Bots in game {}/{}, logins {}, disconnects {}.\n", in_game, Options.Count, stats.Logins, stats.Disconnects );
+    WriteLog( "  Ping ms p50 {}, p90 {}, p99 {}, max {}, samples {}.\n",
+              GetPercentile( stats.Pings, 50 ), GetPercentile( stats.Pings, 90 ), GetPercentile( stats.Pings, 99 ),
+              stats.Pings.empty() ? 0 : stats.Pings.back(), (uint) stats.Pings.size() );
+    WriteLog( "  Receive {:.1f} msg/s, {:.1f} Kb/s (unpacked {:.1f} Kb/s), send {:.1f} Kb/s.\n",
+              stats.MessagesReceive / seconds, stats.BytesReceive / seconds / 1024.0,
+              stats.BytesRealReceive / seconds / 1024.0, stats.BytesSend / seconds / 1024.0 );
+}
+
+int main( int argc, char** argv )
+{
+    InitialSetup( "FOnlineBots", argc, argv );
+
+    Thread::SetCurrentName( "Bots" );
+
+    LogToFile( "./FOnlineBots.log" );
+    WriteLog( "FOnline bots, version {}.\n", FONLINE_VERSION );
+
+    // Options
+    string language = MainConfig->GetStr( "", "BotsLanguage", "russ" );
+    language.resize( 4, ' ' );
+    Options.Host = MainConfig->GetStr( "", "BotsHost", "127.0.0.1" );
+    Options.Port = MainConfig->GetInt( "", "BotsPort", MainConfig->GetInt( "", "Port", 4000 ) );
+    Options.Count = MainConfig->GetInt( "", "BotsCount", 100 );
+    Options.Threads = CLAMP( MainConfig->GetInt( "", "BotsThreads", 4 ), 1, 256 );
+    Options.ConnectRate = MAX( MainConfig->GetInt( "", "BotsConnectRate", 50 ), 1 );
+    Options.NamePrefix = MainConfig->GetStr( "", "BotsNamePrefix", "Bot" );
+    Options.Password = MainConfig->GetStr( "", "BotsPassword", "bot" );
+    memcpy( &Options.Language, language.c_str(), sizeof( Options.Language ) );
+    Options.Register = MainConfig->GetInt( "", "BotsRegister", 1 ) != 0;
+    Options.MovePeriod = MainConfig->GetInt( "", "BotsMovePeriod", 1000 );
+    Options.ChatPeriod = MainConfig->GetInt( "", "BotsChatPeriod", 10000 );
+    Options.PingPeriod = MainConfig->GetInt( "", "BotsPingPeriod", 1000 );
+    Options.LzCompression = MainConfig->GetInt( "", "BotsLzCompression", 0 ) != 0;
+    uint report_period = MAX( MainConfig->GetInt( "", "BotsReportPeriod", 10 ), 1 );
+    uint duration = MainConfig->GetInt( "", "BotsDuration", 0 );
+
+    WriteLog( "Start {} bots on {}:{}, threads {}.\n", Options.Count, Options.Host, Options.Port, Options.Threads );
+
+    #ifdef FO_WINDOWS
+    WSADATA wsa;
+    if( WSAStartup( MAKEWORD( 2, 2 ), &wsa ) )
+    {
+        WriteLog( "WSAStartup error.\n" );
+        return 1;
+    }
+    #endif
+
+    // Spread bots between workers, connections ramped up by rate
+    Statistics.Clear();
+    vector< vector< Bot* > > bots( Options.Threads );
+    uint                     start_tick = Timer::FastTick();
+    for( uint i = 0; i < Options.Count; i++ )
+        bots[ i % Options.Threads ].push_back( new Bot( i, start_tick + i * 1000 / Options.ConnectRate ) );
+
+    vector< Thread > threads( Options.Threads );
+    for( uint i = 0; i < Options.Threads; i++ )
+        threads[ i ].Start( BotsWork, _str( "Bots{}", i ), &bots[ i ] );
+
+    // Reports
+    double last_report = Timer::AccurateTick();
+    while( !duration || Timer::FastTick() - start_tick < duration * 1000 )
+    {
+        // Fast tick used by workers updated only here
+        Thread::Sleep( 10 );
+        Timer::UpdateTick();
+
+        double cur_tick = Timer::AccurateTick();
+        if( cur_tick - last_report >= report_period * 1000.0 )
+        {
+            Report( ( cur_tick - last_report ) / 1000.0 );
+            last_report = cur_tick;
+        }
+    }
+
+    BotsQuit = true;
+    for( Thread& thread : threads )
+        thread.Wait();
+
+    Report( ( Timer::AccurateTick() - last_report ) / 1000.0 );
+    WriteLog( "Bots finished.\n" );
+    return 0;
+}
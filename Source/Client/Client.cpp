@@ -6,6 +6,7 @@
 #include "StringUtils.h"
 #include "IniFile.h"
 #include "Debugger.h"
+#include "NetMessages.h"
 #include "sha1.h"
 #include "sha2.h"
 #include <fcntl.h>
@@ -128,6 +129,7 @@ FOClient::FOClient()
     ComLen = NetBuffer::DefaultBufSize;
     ComBuf = new uchar[ ComLen ];
     ZStreamOk = false;
+    LzDecoder = nullptr;
     Sock = INVALID_SOCKET;
     BytesReceive = 0;
     BytesRealReceive = 0;
@@ -633,7 +635,6 @@ void FOClient::UpdateFilesLoop()
             UpdateFilesFilesChanged = false;
             SAFEDEL( UpdateFilesList );
             UpdateFileDownloading = false;
-            File::DeleteFile( File::GetWritePath( "Update.bin" ) );
             UpdateFilesTick = Timer::FastTick();
 
             Net_SendUpdate();
@@ -668,7 +669,7 @@ void FOClient::UpdateFilesLoop()
 
                 if( update_file.Name[ 0 ] == '$' )
                 {
-                    UpdateFileTemp = FileOpen( File::GetWritePath( "Update.bin" ), true );
+                    UpdateFileTemp = UpdateFilesOpenTemp( update_file );
                     UpdateFilesCacheChanged = true;
                 }
                 else
@@ -682,8 +683,7 @@ void FOClient::UpdateFilesLoop()
                     return;
                     #endif
 
-                    File::DeleteFile( File::GetWritePath( update_file.Name ) );
-                    UpdateFileTemp = FileOpen( File::GetWritePath( "Update.bin" ), true );
+                    UpdateFileTemp = UpdateFilesOpenTemp( update_file );
                     UpdateFilesFilesChanged = true;
                 }
 
@@ -697,8 +697,15 @@ void FOClient::UpdateFilesLoop()
 
                 UpdateFileDownloading = true;
 
-                Bout << NETMSG_GET_UPDATE_FILE;
-                Bout << UpdateFilesList->front().Index;
+                if( update_file.Parts.empty() )
+                {
+                    Bout << NETMSG_GET_UPDATE_FILE;
+                    Bout << update_file.Index;
+                }
+                else
+                {
+                    UpdateFilesNextPart();
+                }
             }
             else
             {
@@ -742,6 +749,153 @@ void FOClient::UpdateFilesAddText( uint num_str, const string& num_str_str )
     }
 }
 
+void* FOClient::UpdateFilesOpenTemp( UpdateFile& update_file )
+{
+    // Whole file download continues from data received before connection loss
+    string temp_path = File::GetWritePath( "Update.bin" );
+    string resume_info = _str( "{} {}", update_file.Hash, update_file.Name );
+    if( update_file.Parts.empty() && Crypt.GetCache( "UpdateResume" ) == resume_info )
+    {
+        void* temp_file = FileOpenForAppend( temp_path );
+        uint  temp_size = ( temp_file ? FileGetSize( temp_file ) : 0 );
+        if( temp_size && temp_size < update_file.Size )
+        {
+            // Rest requested as range, whole file downloaded again if result not match to hash
+            UpdateFilePart part;
+            part.Offset = temp_size;
+            part.Size = update_file.Size - temp_size;
+            part.Local = false;
+            update_file.Parts.push_back( part );
+            update_file.RemaningSize = part.Size;
+            update_file.Assembled = true;
+            UpdateFilesWholeSize -= temp_size;
+            return temp_file;
+        }
+        if( temp_file )
+            FileClose( temp_file );
+    }
+
+    if( update_file.Parts.empty() )
+        Crypt.SetCache( "UpdateResume", resume_info );
+    else
+        Crypt.EraseCache( "UpdateResume" );
+    return FileOpen( temp_path, true );
+}
+
+void FOClient::UpdateFilesNextPart()
+{
+    UpdateFile& update_file = UpdateFilesList->front();
+
+    // Copy unchanged chunks from current version of file
+    if( !update_file.Parts.empty() && update_file.Parts.front().Local )
+    {
+        void* local_file = FileOpen( File::GetWritePath( update_file.Name ), false );
+        if( !local_file )
+        {
+            UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't load update file!" );
+            return;
+        }
+
+        UCharVec buf;
+        while( !update_file.Parts.empty() && update_file.Parts.front().Local )
+        {
+            UpdateFilePart& part = update_file.Parts.front();
+            buf.resize( part.Size );
+            if( !FileSetPointer( local_file, part.Offset, SEEK_SET ) || !FileRead( local_file, &buf[ 0 ], part.Size ) ||
+                !FileWrite( UpdateFileTemp, &buf[ 0 ], part.Size ) )
+            {
+                FileClose( local_file );
+                UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't write update file!" );
+                return;
+            }
+
+            update_file.RemaningSize -= part.Size;
+            update_file.Parts.erase( update_file.Parts.begin() );
+        }
+        FileClose( local_file );
+    }
+
+    if( update_file.Parts.empty() )
+    {
+        UpdateFilesFinalize();
+        return;
+    }
+
+    // Request changed chunks
+    UpdateFilePart& part = update_file.Parts.front();
+    Bout << NETMSG_GET_UPDATE_FILE_PART;
+    Bout << update_file.Index;
+    Bout << part.Offset;
+    Bout << part.Size;
+}
+
+void FOClient::UpdateFilesFinalize()
+{
+    UpdateFile& update_file = UpdateFilesList->front();
+
+    FileClose( UpdateFileTemp );
+    UpdateFileTemp = nullptr;
+
+    void* temp_file = FileOpen( File::GetWritePath( "Update.bin" ), false );
+    if( !temp_file )
+    {
+        UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't load update file!" );
+        return;
+    }
+
+    uint     len = FileGetSize( temp_file );
+    UCharVec buf( len );
+    if( len && !FileRead( temp_file, &buf[ 0 ], len ) )
+    {
+        UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't read update file!" );
+        FileClose( temp_file );
+        return;
+    }
+    FileClose( temp_file );
+
+    // Verify whole file, assembled one downloaded again entirely
+    if( len != update_file.Size || Crypt.MurmurHash2( buf.data(), len ) != update_file.Hash )
+    {
+        if( !update_file.Assembled )
+        {
+            UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Update file corrupted!" );
+            return;
+        }
+
+        WriteLog( "Assembled update file '{}' not match to hash, download it again.\n", update_file.Name );
+        File::DeleteFile( File::GetWritePath( "Update.bin" ) );
+        update_file.Parts.clear();
+        update_file.Assembled = false;
+        update_file.RemaningSize = update_file.Size;
+        UpdateFilesWholeSize += update_file.Size;
+        UpdateFileDownloading = false;
+        return;
+    }
+
+    // Cache
+    if( update_file.Name[ 0 ] == '$' )
+    {
+        Crypt.SetCache( update_file.Name, buf.data(), len );
+        Crypt.SetCache( update_file.Name + ".hash", (uchar*) &update_file.Hash, sizeof( update_file.Hash ) );
+        File::DeleteFile( File::GetWritePath( "Update.bin" ) );
+    }
+    // File
+    else
+    {
+        string from_path = File::GetWritePath( "Update.bin" );
+        string to_path = File::GetWritePath( update_file.Name );
+        File::DeleteFile( to_path );
+        if( !File::RenameFile( from_path, to_path ) )
+        {
+            UpdateFilesAbort( STR_FILESYSTEM_ERROR, _str( "Can't rename file '{}' to '{}'!", from_path, to_path ) );
+            return;
+        }
+    }
+
+    UpdateFilesList->erase( UpdateFilesList->begin() );
+    UpdateFileDownloading = false;
+}
+
 void FOClient::UpdateFilesAbort( uint num_str, const string& num_str_str )
 {
     UpdateFilesAborted = true;
@@ -1823,6 +1977,14 @@ bool FOClient::NetConnect( const char* host, ushort port )
     }
     #endif
 
+    // Fast codec of incoming data, request goes first
+    SAFEDEL( LzDecoder );
+    if( MainConfig->GetInt( "", "NetLzCompression", 0 ) )
+    {
+        LzDecoder = new NetLzDecoder();
+        NetMessages::WriteCompression( Bout, NET_COMPRESSION_LZ );
+    }
+
     IsConnecting = true;
     return true;
 }
@@ -1866,6 +2028,7 @@ void FOClient::NetDisconnect()
     if( ZStreamOk )
         inflateEnd( &ZStream );
     ZStreamOk = false;
+    SAFEDEL( LzDecoder );
     if( Sock != INVALID_SOCKET )
         closesocket( Sock );
     Sock = INVALID_SOCKET;
@@ -2009,7 +2172,15 @@ int FOClient::NetInput( bool unpack )
     Bin.Refresh();
     uint old_pos = Bin.GetEndPos();
 
-    if( unpack && !GameOpt.DisableZlibCompression )
+    if( unpack && LzDecoder )
+    {
+        if( !LzDecoder->Decompress( ComBuf, whole_len, Bin ) )
+        {
+            WriteLog( "Invalid compressed data received from server.\n" );
+            return -1;
+        }
+    }
+    else if( unpack && !GameOpt.DisableZlibCompression )
     {
         ZStream.next_in = ComBuf;
         ZStream.avail_in = whole_len;
@@ -2274,23 +2445,7 @@ void FOClient::Net_SendUpdate()
 
 void FOClient::Net_SendLogIn()
 {
-    char name_[ UTF8_BUF_SIZE( MAX_NAME ) ] = { 0 };
-    char pass_[ UTF8_BUF_SIZE( MAX_NAME ) ] = { 0 };
-    memzero( name_, sizeof( name_ ) );
-    Str::Copy( name_, LoginName.c_str() );
-    memzero( pass_, sizeof( pass_ ) );
-    Str::Copy( pass_, LoginPassword.c_str() );
-
-    Bout << NETMSG_LOGIN;
-    Bout << (ushort) FONLINE_VERSION;
-
-    // Begin data encrypting
-    Bout.SetEncryptKey( 12345 );
-    Bin.SetEncryptKey( 12345 );
-
-    Bout.Push( name_, sizeof( name_ ) );
-    Bout.Push( pass_, sizeof( pass_ ) );
-    Bout << CurLang.Name;
+    NetMessages::WriteLogIn( Bout, Bin, LoginName, LoginPassword, CurLang.Name );
 
     AddMess( FOMB_GAME, CurLang.Msg[ TEXTMSG_GAME ].GetStr( STR_NET_CONN_SUCCESS ) );
 }
@@ -2298,26 +2453,7 @@ void FOClient::Net_SendLogIn()
 void FOClient::Net_SendCreatePlayer()
 {
     WriteLog( "Player registration..." );
-
-    uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( ushort ) + UTF8_BUF_SIZE( MAX_NAME ) * 2;
-
-    Bout << NETMSG_CREATE_CLIENT;
-    Bout << msg_len;
-
-    Bout << (ushort) FONLINE_VERSION;
-
-    // Begin data encrypting
-    Bout.SetEncryptKey( 1234567890 );
-    Bin.SetEncryptKey( 1234567890 );
-
-    char buf[ UTF8_BUF_SIZE( MAX_NAME ) ];
-    memzero( buf, sizeof( buf ) );
-    Str::Copy( buf, LoginName.c_str() );
-    Bout.Push( buf, UTF8_BUF_SIZE( MAX_NAME ) );
-    memzero( buf, sizeof( buf ) );
-    Str::Copy( buf, LoginPassword.c_str() );
-    Bout.Push( buf, UTF8_BUF_SIZE( MAX_NAME ) );
-
+    NetMessages::WriteCreatePlayer( Bout, Bin, LoginName, LoginPassword );
     WriteLog( "complete.\n" );
 }
 
@@ -2336,14 +2472,7 @@ void FOClient::Net_SendText( const char* send_str, uchar how_say )
     if( !result || str.empty() )
         return;
 
-    ushort len = (ushort) str.length();
-    uint   msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( how_say ) + sizeof( len ) + len;
-
-    Bout << NETMSG_SEND_TEXT;
-    Bout << msg_len;
-    Bout << how_say;
-    Bout << len;
-    Bout.Push( str.c_str(), len );
+    NetMessages::WriteText( Bout, str, how_say );
 }
 
 void FOClient::Net_SendDir()
@@ -2375,10 +2504,7 @@ void FOClient::Net_SendMove( UCharVec steps )
     if( steps.empty() )
         SETFLAG( move_params, MOVE_PARAM_STEP_DISALLOW );                // Inform about stopping
 
-    Bout << ( Chosen->IsRunning ? NETMSG_SEND_MOVE_RUN : NETMSG_SEND_MOVE_WALK );
-    Bout << move_params;
-    Bout << Chosen->GetHexX();
-    Bout << Chosen->GetHexY();
+    NetMessages::WriteMove( Bout, Chosen->IsRunning, move_params, Chosen->GetHexX(), Chosen->GetHexY() );
 }
 
 void FOClient::Net_SendProperty( NetProperty::Type type, Property* prop, Entity* entity )
@@ -2478,13 +2604,12 @@ void FOClient::Net_SendGiveMap( bool automap, hash map_pid, uint loc_id, hash ti
 
 void FOClient::Net_SendLoadMapOk()
 {
-    Bout << NETMSG_SEND_LOAD_MAP_OK;
+    NetMessages::WriteLoadMapOk( Bout );
 }
 
 void FOClient::Net_SendPing( uchar ping )
 {
-    Bout << NETMSG_PING;
-    Bout << ping;
+    NetMessages::WritePing( Bout, ping );
 }
 
 void FOClient::Net_SendRefereshMe()
@@ -4318,6 +4443,12 @@ void FOClient::Net_OnUpdateFilesList()
     File fm;
     fm.LoadStream( &data[ 0 ], (uint) data.size() );
 
+    if( data.size() < sizeof( uint ) || fm.GetLEUInt() != UPDATE_FILES_LIST_VERSION )
+    {
+        UpdateFilesAbort( STR_CLIENT_OUTDATED, "Client outdated!" );
+        return;
+    }
+
     SAFEDEL( UpdateFilesList );
     UpdateFilesList = new UpdateFileVec();
     UpdateFilesWholeSize = 0;
@@ -4341,6 +4472,14 @@ void FOClient::Net_OnUpdateFilesList()
         fm.GoForward( name_len );
         uint   size = fm.GetLEUInt();
         uint   hash = fm.GetLEUInt();
+        uint   chunks_count = fm.GetLEUInt();
+        UIntVec chunk_sizes( chunks_count );
+        UIntVec chunk_hashes( chunks_count );
+        for( uint i = 0; i < chunks_count; i++ )
+        {
+            chunk_sizes[ i ] = fm.GetLEUInt();
+            chunk_hashes[ i ] = fm.GetLEUInt();
+        }
 
         // Skip platform depended
         #ifdef FO_WINDOWS
@@ -4356,6 +4495,7 @@ void FOClient::Net_OnUpdateFilesList()
         #endif
 
         // Check hash
+        File  local_file;
         uint  cur_hash_len;
         uint* cur_hash = (uint*) Crypt.GetCache( _str( "{}.hash", name ), cur_hash_len );
         bool  cached_hash_same = ( cur_hash && cur_hash_len == sizeof( hash ) && *cur_hash == hash );
@@ -4387,8 +4527,48 @@ void FOClient::Net_OnUpdateFilesList()
         update_file.Size = size;
         update_file.RemaningSize = size;
         update_file.Hash = hash;
+        update_file.Assembled = false;
+
+        // Reuse unchanged chunks of previous version, download only changed ones
+        uint download_size = size;
+        if( chunks_count && local_file.LoadFile( File::GetWritePath( name ) ) && local_file.GetFsize() )
+        {
+            UIntVec local_sizes, local_hashes;
+            Crypt.SplitToChunks( local_file.GetBuf(), local_file.GetFsize(), local_sizes, local_hashes );
+
+            map< uint, pair< uint, uint > > local_chunks; // Hash -> offset, size
+            for( uint i = 0, offset = 0; i < (uint) local_sizes.size(); offset += local_sizes[ i ], i++ )
+                local_chunks.insert( std::make_pair( local_hashes[ i ], std::make_pair( offset, local_sizes[ i ] ) ) );
+
+            download_size = 0;
+            for( uint i = 0, offset = 0; i < chunks_count; offset += chunk_sizes[ i ], i++ )
+            {
+                auto it = local_chunks.find( chunk_hashes[ i ] );
+                bool local = ( it != local_chunks.end() && it->second.second == chunk_sizes[ i ] );
+                uint part_offset = ( local ? it->second.first : offset );
+                if( !local )
+                    download_size += chunk_sizes[ i ];
+
+                // Merge with previous part if continues it
+                UpdateFilePartVec& parts = update_file.Parts;
+                if( !parts.empty() && parts.back().Local == local && parts.back().Offset + parts.back().Size == part_offset )
+                {
+                    parts.back().Size += chunk_sizes[ i ];
+                }
+                else
+                {
+                    UpdateFilePart part;
+                    part.Offset = part_offset;
+                    part.Size = chunk_sizes[ i ];
+                    part.Local = local;
+                    parts.push_back( part );
+                }
+            }
+            update_file.Assembled = true;
+        }
+
         UpdateFilesList->push_back( update_file );
-        UpdateFilesWholeSize += size;
+        UpdateFilesWholeSize += download_size;
     }
 
     #ifdef FO_WINDOWS
@@ -4403,72 +4583,63 @@ void FOClient::Net_OnUpdateFilesList()
 void FOClient::Net_OnUpdateFileData()
 {
     // Get portion
+    uint msg_len;
+    Bin >> msg_len;
+
+    uint portion_size = msg_len - sizeof( uint ) - sizeof( msg_len );
+    if( portion_size > FILE_UPDATE_PORTION )
+    {
+        UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Invalid update file portion!" );
+        return;
+    }
+
     uchar data[ FILE_UPDATE_PORTION ];
-    Bin.Pop( data, sizeof( data ) );
+    Bin.Pop( data, portion_size );
 
     CHECK_IN_BUFF_ERROR;
 
     UpdateFile& update_file = UpdateFilesList->front();
+    uint        need_size = MIN( update_file.RemaningSize, (uint) sizeof( data ) );
+    if( !update_file.Parts.empty() )
+        need_size = MIN( update_file.Parts.front().Size, (uint) sizeof( data ) );
+    if( portion_size != need_size )
+    {
+        UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Invalid update file portion!" );
+        return;
+    }
 
     // Write data to temp file
-    if( !FileWrite( UpdateFileTemp, data, MIN( update_file.RemaningSize, sizeof( data ) ) ) )
+    if( !FileWrite( UpdateFileTemp, data, portion_size ) )
     {
         UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't write update file!" );
         return;
     }
 
     // Get next portion or finalize data
-    update_file.RemaningSize -= MIN( update_file.RemaningSize, sizeof( data ) );
-    if( update_file.RemaningSize > 0 )
+    update_file.RemaningSize -= portion_size;
+    if( !update_file.Parts.empty() )
     {
-        // Request next portion
-        Bout << NETMSG_GET_UPDATE_FILE_DATA;
-    }
-    else
-    {
-        // Finalize received data
-        FileClose( UpdateFileTemp );
-        UpdateFileTemp = nullptr;
-
-        // Cache
-        if( update_file.Name[ 0 ] == '$' )
+        // Continue requested part or go to next one
+        UpdateFilePart& part = update_file.Parts.front();
+        part.Size -= portion_size;
+        if( part.Size > 0 )
         {
-            void* temp_file = FileOpen( File::GetWritePath( "Update.bin" ), false );
-            if( !temp_file )
-            {
-                UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't load update file!" );
-                return;
-            }
-
-            uint     len = FileGetSize( temp_file );
-            UCharVec buf( len );
-            if( !FileRead( temp_file, &buf[ 0 ], len ) )
-            {
-                UpdateFilesAbort( STR_FILESYSTEM_ERROR, "Can't read update file!" );
-                FileClose( temp_file );
-                return;
-            }
-            FileClose( temp_file );
-
-            Crypt.SetCache( update_file.Name, &buf[ 0 ], len );
-            Crypt.SetCache( update_file.Name + ".hash", (uchar*) &update_file.Hash, sizeof( update_file.Hash ) );
-            File::DeleteFile( File::GetWritePath( "Update.bin" ) );
+            Bout << NETMSG_GET_UPDATE_FILE_DATA;
         }
-        // File
         else
         {
-            string from_path = File::GetWritePath( "Update.bin" );
-            string to_path = File::GetWritePath( update_file.Name );
-            File::DeleteFile( to_path );
-            if( !File::RenameFile( from_path, to_path ) )
-            {
-                UpdateFilesAbort( STR_FILESYSTEM_ERROR, _str( "Can't rename file '{}' to '{}'!", from_path, to_path ) );
-                return;
-            }
+            update_file.Parts.erase( update_file.Parts.begin() );
+            UpdateFilesNextPart();
         }
-
-        UpdateFilesList->erase( UpdateFilesList->begin() );
-        UpdateFileDownloading = false;
+    }
+    else if( update_file.RemaningSize > 0 )
+    {
+        // Request next portion
+        Bout << NETMSG_GET_UPDATE_FILE_DATA;
+    }
+    else
+    {
+        UpdateFilesFinalize();
     }
 }
 
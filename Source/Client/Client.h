@@ -10,6 +10,7 @@
 #include "ItemView.h"
 #include "CritterView.h"
 #include "NetBuffer.h"
+#include "NetCompression.h"
 #include "ResourceManager.h"
 #include "Script.h"
 #include "zlib.h"
@@ -105,13 +106,23 @@ public:
     void ParseMouse();
 
     // Update files
+    struct UpdateFilePart
+    {
+        uint Offset; // In current local file if local, otherwise in server file
+        uint Size;
+        bool Local;
+    };
+    typedef vector< UpdateFilePart > UpdateFilePartVec;
+
     struct UpdateFile
     {
-        uint   Index;
-        string Name;
-        uint   Size;
-        uint   RemaningSize;
-        uint   Hash;
+        uint              Index;
+        string            Name;
+        uint              Size;
+        uint              RemaningSize;
+        uint              Hash;
+        UpdateFilePartVec Parts;     // Empty if whole file downloaded
+        bool              Assembled; // Built from parts, downloaded again as whole if hash not match
     };
     typedef vector< UpdateFile > UpdateFileVec;
 
@@ -133,30 +144,34 @@ public:
 
     void UpdateFilesStart();
     void UpdateFilesLoop();
+    void* UpdateFilesOpenTemp( UpdateFile& update_file );
+    void UpdateFilesNextPart();
+    void UpdateFilesFinalize();
     void UpdateFilesAddText( uint num_str, const string& num_str_str );
     void UpdateFilesAbort( uint num_str, const string& num_str_str );
 
     // Network
-    uchar*      ComBuf;
-    uint        ComLen;
-    NetBuffer   Bin;
-    NetBuffer   Bout;
-    z_stream    ZStream;
-    bool        ZStreamOk;
-    uint        BytesReceive, BytesRealReceive, BytesSend;
-    sockaddr_in SockAddr, ProxyAddr;
-    SOCKET      Sock;
-    fd_set      SockSet;
-    ItemView*   SomeItem;
-    bool        IsConnecting;
-    bool        IsConnected;
-    bool        InitNetBegin;
-    int         InitNetReason;
-    bool        InitialItemsSend;
-    UCharVecVec GlovalVarsPropertiesData;
-    UCharVecVec TempPropertiesData;
-    UCharVecVec TempPropertiesDataExt;
-    UCharVec    TempPropertyData;
+    uchar*        ComBuf;
+    uint          ComLen;
+    NetBuffer     Bin;
+    NetBuffer     Bout;
+    z_stream      ZStream;
+    bool          ZStreamOk;
+    NetLzDecoder* LzDecoder;
+    uint          BytesReceive, BytesRealReceive, BytesSend;
+    sockaddr_in   SockAddr, ProxyAddr;
+    SOCKET        Sock;
+    fd_set        SockSet;
+    ItemView*     SomeItem;
+    bool          IsConnecting;
+    bool          IsConnected;
+    bool          InitNetBegin;
+    int           InitNetReason;
+    bool          InitialItemsSend;
+    UCharVecVec   GlovalVarsPropertiesData;
+    UCharVecVec   TempPropertiesData;
+    UCharVecVec   TempPropertiesDataExt;
+    UCharVec      TempPropertyData;
 
     bool CheckSocketStatus( bool for_write );
     bool NetConnect( const char* host, ushort port );
@@ -26,14 +26,14 @@ public:
     // Core
     CLASS_PROPERTY( hash, ModelName );
     CLASS_PROPERTY( hash, ScriptId );
-    CLASS_PROPERTY( uint, LookDistance );
+    CLASS_VIRTUAL_PROPERTY( uint, LookDistance );
     CLASS_PROPERTY( CScriptArray *, Anim3dLayer );
     CLASS_PROPERTY( hash, DialogId );
     CLASS_PROPERTY( bool, IsNoTalk );
     CLASS_PROPERTY( uint, TalkDistance );
     CLASS_PROPERTY( int, CurrentHp );
-    CLASS_PROPERTY( bool, IsNoWalk );
-    CLASS_PROPERTY( bool, IsNoRun );
+    CLASS_VIRTUAL_PROPERTY( bool, IsNoWalk );
+    CLASS_VIRTUAL_PROPERTY( bool, IsNoRun );
     CLASS_PROPERTY( bool, IsNoRotate );
     CLASS_PROPERTY( uint, WalkTime );
     CLASS_PROPERTY( uint, RunTime );
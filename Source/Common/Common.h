@@ -105,6 +105,7 @@
 #include <deque>
 #include <sstream>
 #include <tuple>
+#include <unordered_map>
 
 // String formatting
 #include "fmt/format.h"
@@ -133,6 +134,8 @@ using std::list;
 using std::vector;
 using std::map;
 using std::multimap;
+using std::unordered_map;
+using std::unordered_multimap;
 using std::set;
 using std::deque;
 using std::pair;
@@ -432,7 +435,7 @@ using UIntHashVecMap = map< uint, HashVec >;
 #define MAX_DLG_LEXEMS_TEXT          ( 1000 )
 #define MAX_BUF_LEN                  ( 4096 )
 #define PASS_HASH_SIZE               ( 32 )
-#define FILE_UPDATE_PORTION          ( 16384 )
+#define FILE_UPDATE_PORTION          ( 65536 )
 
 // Critters
 #define MAKE_CLIENT_ID( name )                ( ( 1 << 31 ) | _str( name ).toHash() )
@@ -516,6 +519,8 @@ using UIntHashVecMap = map< uint, HashVec >;
 #define LOOK_CHECK_TRACE             ( 0x08 )
 #define LOOK_CHECK_SCRIPT            ( 0x10 )
 #define LOOK_CHECK_ITEM_SCRIPT       ( 0x20 )
+#define LOOK_CHECK_NEIGHBORS         ( 0x40 )
+#define LOOK_CHECK_NEIGHBORS_VERIFY  ( 0x80 )
 
 // In SendMessage
 #define MESSAGE_TO_VISIBLE_ME        ( 0 )
@@ -52,6 +52,58 @@ uint CryptManager::MurmurHash2( const uchar* data, uint len )
     return h;
 }
 
+// Content defined chunking, boundaries depend only on nearby bytes
+// so insertion or removal of data changes only chunks around it
+#define CHUNK_MIN_SIZE    ( 8 * 1024 )
+#define CHUNK_MAX_SIZE    ( 128 * 1024 )
+#define CHUNK_MASK        ( 0x7FFF ) // Average size about 32Kb above minimum
+
+void CryptManager::SplitToChunks( const uchar* data, uint len, UIntVec& chunk_sizes, UIntVec& chunk_hashes )
+{
+    // Table must be same on all platforms, so fill it by own generator
+    static uint gear[ 256 ];
+    static bool gear_ready = false;
+    if( !gear_ready )
+    {
+        uint x = 0x9E3779B9;
+        for( int i = 0; i < 256; i++ )
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            gear[ i ] = x;
+        }
+        gear_ready = true;
+    }
+
+    chunk_sizes.clear();
+    chunk_hashes.clear();
+
+    uint begin = 0;
+    while( begin < len )
+    {
+        uint remaining = len - begin;
+        uint size = MIN( remaining, (uint) CHUNK_MAX_SIZE );
+        if( remaining > CHUNK_MIN_SIZE )
+        {
+            uint fp = 0;
+            for( uint i = CHUNK_MIN_SIZE; i < size; i++ )
+            {
+                fp = ( fp << 1 ) + gear[ data[ begin + i ] ];
+                if( !( fp & CHUNK_MASK ) )
+                {
+                    size = i + 1;
+                    break;
+                }
+            }
+        }
+
+        chunk_sizes.push_back( size );
+        chunk_hashes.push_back( MurmurHash2( data + begin, size ) );
+        begin += size;
+    }
+}
+
 uint64 CryptManager::MurmurHash2_64( const uchar* data, uint len )
 {
     #if defined ( FO_X64 )
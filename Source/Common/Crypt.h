@@ -8,6 +8,7 @@ class CryptManager
 public:
     uint   MurmurHash2( const uchar* data, uint len );
     uint64 MurmurHash2_64( const uchar* data, uint len );
+    void   SplitToChunks( const uchar* data, uint len, UIntVec& chunk_sizes, UIntVec& chunk_hashes );
     void   XOR( uchar* data, uint len, const uchar* xor_key, uint xor_len );
     string ClientPassHash( const string& name, const string& pass );
 
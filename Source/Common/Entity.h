@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "Properties.h"
 #include "MsgFiles.h"
+#include "SpatialGrid.h"
 
 enum class EntityType
 {
@@ -218,6 +219,8 @@ public:
     ItemVec    StaticItemsVec;
     ItemVec    TriggerItemsVec;
     uchar*     HexFlags;
+
+    HexSpatialGrid< Item > StaticItemsGrid;
     #endif
 
     #if defined ( FONLINE_EDITOR )
@@ -6,6 +6,7 @@
 #else
 # include <dirent.h>
 # include <sys/stat.h>
+# include <unistd.h>
 #endif
 
 #ifdef FO_WINDOWS
@@ -103,6 +104,11 @@ bool FileWrite( void* file, const void* buf, uint len )
     return WriteFile( (HANDLE) file, buf, len, &dw, nullptr ) && dw == len;
 }
 
+bool FileSync( void* file )
+{
+    return FlushFileBuffers( (HANDLE) file ) != FALSE;
+}
+
 bool FileSetPointer( void* file, int offset, int origin )
 {
     return SetFilePointer( (HANDLE) file, offset, nullptr, origin ) != INVALID_SET_FILE_POINTER;
@@ -226,6 +232,18 @@ bool FileWrite( void* file, const void* buf, uint len )
     return result;
 }
 
+bool FileSync( void* file )
+{
+    SDL_RWops* ops = ( (FileDesc*) file )->Ops;
+    if( ops->type == SDL_RWOPS_STDFILE )
+    {
+        # ifdef HAVE_STDIO_H
+        return fflush( ops->hidden.stdio.fp ) == 0 && fsync( fileno( ops->hidden.stdio.fp ) ) == 0;
+        # endif
+    }
+    return true;
+}
+
 bool FileSetPointer( void* file, int offset, int origin )
 {
     return SDL_RWseek( ( ( (FileDesc*) file )->Ops ), offset, origin ) != -1;
@@ -359,6 +377,12 @@ bool FileWrite( void* file, const void* buf, uint len )
     return result;
 }
 
+bool FileSync( void* file )
+{
+    FILE* f = ( (FileDesc*) file )->File;
+    return fflush( f ) == 0 && fsync( fileno( f ) ) == 0;
+}
+
 bool FileSetPointer( void* file, int offset, int origin )
 {
     return fseek( ( (FileDesc*) file )->File, offset, origin ) == 0;
@@ -463,7 +487,7 @@ void FileFindClose( void* descriptor )
 
 bool FileDelete( const string& fname )
 {
-    return remove( fname.c_str() );
+    return !remove( fname.c_str() );
 }
 
 bool FileExist( const string& fname )
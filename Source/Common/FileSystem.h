@@ -15,6 +15,7 @@ void*  FileOpenForReadWrite( const string& fname, bool write_through = false );
 void   FileClose( void* file );
 bool   FileRead( void* file, void* buf, uint len, uint* rb = nullptr );
 bool   FileWrite( void* file, const void* buf, uint len );
+bool   FileSync( void* file ); // Flush written data to disk
 bool   FileSetPointer( void* file, int offset, int origin );
 uint   FileGetPointer( void* file );
 uint64 FileGetWriteTime( void* file );
@@ -124,6 +124,15 @@ void NetBuffer::MoveReadPos( int val )
     EncryptKey( val );
 }
 
+// Already pushed value, key position must be taken before push
+uint NetBuffer::PeekUInt( uint pos, int key_pos )
+{
+    uint value = 0;
+    if( pos + sizeof( value ) <= bufEndPos )
+        CopyBuf( bufData + pos, &value, encryptActive ? encryptKeys[ key_pos ] : 0, sizeof( value ) );
+    return value;
+}
+
 void NetBuffer::Push( const void* buf, uint len, bool no_crypt /* = false */ )
 {
     if( isError || !len )
@@ -134,6 +143,23 @@ void NetBuffer::Push( const void* buf, uint len, bool no_crypt /* = false */ )
     bufEndPos += len;
 }
 
+void NetBuffer::Push( NetFrame& frame )
+{
+    if( isError || frame.IsEmpty() )
+        return;
+    if( bufEndPos + frame.GetDataSize() >= bufLen )
+        GrowBuf( frame.GetDataSize() );
+    const uchar* buf = frame.GetData();
+    const uint*  chunks = frame.GetChunks();
+    for( uint i = 0, j = frame.GetChunksCount(); i < j; i++ )
+    {
+        uint len = chunks[ i ];
+        CopyBuf( buf, bufData + bufEndPos, EncryptKey( len ), len );
+        bufEndPos += len;
+        buf += len;
+    }
+}
+
 void NetBuffer::Pop( void* buf, uint len )
 {
     if( isError || !len )
@@ -164,9 +190,25 @@ void NetBuffer::Cut( uint len )
 
 void NetBuffer::CopyBuf( const void* from, void* to, uchar crypt_key, uint len )
 {
+    if( !crypt_key )
+    {
+        memmove( to, from, len );
+        return;
+    }
+
     const uchar* from_ = (const uchar*) from;
     uchar*       to_ = (uchar*) to;
-    for( uint i = 0; i < len; i++, to_++, from_++ )
+
+    // Eight bytes per step for big portions
+    uint64 crypt_key8 = crypt_key * 0x0101010101010101ULL;
+    for( ; len >= sizeof( uint64 ); len -= sizeof( uint64 ), to_ += sizeof( uint64 ), from_ += sizeof( uint64 ) )
+    {
+        uint64 value;
+        memcpy( &value, from_, sizeof( value ) );
+        value ^= crypt_key8;
+        memcpy( to_, &value, sizeof( value ) );
+    }
+    for( ; len; len--, to_++, from_++ )
         *to_ = *from_ ^ crypt_key;
 }
 
@@ -193,6 +235,8 @@ bool NetBuffer::NeedProcess()
         return ( NETMSG_REGISTER_SUCCESS_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_PING:
         return ( NETMSG_PING_SIZE + bufReadPos <= bufEndPos );
+    case NETMSG_COMPRESSION:
+        return ( NETMSG_COMPRESSION_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_END_PARSE_TO_GAME:
         return ( NETMSG_END_PARSE_TO_GAME_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_UPDATE:
@@ -201,8 +245,8 @@ bool NetBuffer::NeedProcess()
         return ( NETMSG_GET_UPDATE_FILE_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_GET_UPDATE_FILE_DATA:
         return ( NETMSG_GET_UPDATE_FILE_DATA_SIZE + bufReadPos <= bufEndPos );
-    case NETMSG_UPDATE_FILE_DATA:
-        return ( NETMSG_UPDATE_FILE_DATA_SIZE + bufReadPos <= bufEndPos );
+    case NETMSG_GET_UPDATE_FILE_PART:
+        return ( NETMSG_GET_UPDATE_FILE_PART_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_REMOVE_CRITTER:
         return ( NETMSG_REMOVE_CRITTER_SIZE + bufReadPos <= bufEndPos );
     case NETMSG_MSG:
@@ -323,6 +367,7 @@ bool NetBuffer::NeedProcess()
     case NETMSG_LOADMAP:
     case NETMSG_CREATE_CLIENT:
     case NETMSG_UPDATE_FILES_LIST:
+    case NETMSG_UPDATE_FILE_DATA:
     case NETMSG_ADD_PLAYER:
     case NETMSG_ADD_NPC:
     case NETMSG_SEND_COMMAND:
@@ -384,6 +429,9 @@ void NetBuffer::SkipMsg( uint msg )
     case NETMSG_PING:
         size = NETMSG_PING_SIZE;
         break;
+    case NETMSG_COMPRESSION:
+        size = NETMSG_COMPRESSION_SIZE;
+        break;
     case NETMSG_END_PARSE_TO_GAME:
         size = NETMSG_END_PARSE_TO_GAME_SIZE;
         break;
@@ -396,8 +444,8 @@ void NetBuffer::SkipMsg( uint msg )
     case NETMSG_GET_UPDATE_FILE_DATA:
         size = NETMSG_GET_UPDATE_FILE_DATA_SIZE;
         break;
-    case NETMSG_UPDATE_FILE_DATA:
-        size = NETMSG_UPDATE_FILE_DATA_SIZE;
+    case NETMSG_GET_UPDATE_FILE_PART:
+        size = NETMSG_GET_UPDATE_FILE_PART_SIZE;
         break;
     case NETMSG_REMOVE_CRITTER:
         size = NETMSG_REMOVE_CRITTER_SIZE;
@@ -557,6 +605,7 @@ void NetBuffer::SkipMsg( uint msg )
     case NETMSG_LOADMAP:
     case NETMSG_CREATE_CLIENT:
     case NETMSG_UPDATE_FILES_LIST:
+    case NETMSG_UPDATE_FILE_DATA:
     case NETMSG_ADD_PLAYER:
     case NETMSG_ADD_NPC:
     case NETMSG_SEND_COMMAND:
@@ -5,6 +5,80 @@
 #include "Threading.h"
 #include "Exception.h"
 
+// Message serialized once and pushed to many buffers, used for broadcasts
+// Push boundaries are kept, because receiver applies encryption key per pushed chunk
+// Small messages stay in inline storage, to not allocate on every broadcast
+class NetFrame
+{
+private:
+    static const uint InlineDataSize = 256;
+    static const uint InlineChunksCount = 32;
+
+    uchar    inlineData[ InlineDataSize ];
+    uint     inlineChunks[ InlineChunksCount ];
+    uint     dataSize = 0;
+    uint     chunksCount = 0;
+    UCharVec frameData;
+    UIntVec  frameChunks;
+
+public:
+    void Push( const void* buf, uint len )
+    {
+        if( !len )
+            return;
+
+        if( frameData.empty() && dataSize + len <= InlineDataSize )
+        {
+            memcpy( inlineData + dataSize, buf, len );
+        }
+        else
+        {
+            if( frameData.empty() )
+                frameData.assign( inlineData, inlineData + dataSize );
+            frameData.insert( frameData.end(), (const uchar*) buf, (const uchar*) buf + len );
+        }
+        dataSize += len;
+
+        if( frameChunks.empty() && chunksCount < InlineChunksCount )
+        {
+            inlineChunks[ chunksCount ] = len;
+        }
+        else
+        {
+            if( frameChunks.empty() )
+                frameChunks.assign( inlineChunks, inlineChunks + chunksCount );
+            frameChunks.push_back( len );
+        }
+        chunksCount++;
+    }
+
+    const uchar* GetData()        { return frameData.empty() ? inlineData : &frameData[ 0 ]; }
+    uint         GetDataSize()    { return dataSize; }
+    const uint*  GetChunks()      { return frameChunks.empty() ? inlineChunks : &frameChunks[ 0 ]; }
+    uint         GetChunksCount() { return chunksCount; }
+    bool         IsEmpty()        { return !dataSize; }
+
+    template< typename T >
+    NetFrame& operator<<( const T& i )
+    {
+        Push( &i, sizeof( T ) );
+        return *this;
+    }
+
+    NetFrame& operator<<( const string& i )
+    {
+        RUNTIME_ASSERT( i.length() <= 65535 );
+        ushort len = (ushort) i.length();
+        Push( &len, sizeof( len ) );
+        Push( i.c_str(), len );
+        return *this;
+    }
+
+    NetFrame& operator<<( const uint64& i ) = delete;
+    NetFrame& operator<<( const float& i ) = delete;
+    NetFrame& operator<<( const double& i ) = delete;
+};
+
 class NetBuffer
 {
 public:
@@ -37,6 +111,7 @@ public:
     void   Reset();
     void   LockReset();
     void   Push( const void* buf, uint len, bool no_crypt = false );
+    void   Push( NetFrame& frame );
     void   Pop( void* buf, uint len );
     void   Cut( uint len );
     void   GrowBuf( uint len );
@@ -47,6 +122,8 @@ public:
     void   SetEndPos( uint pos ) { bufEndPos = pos; }
     uint   GetEndPos()           { return bufEndPos; }
     void   MoveReadPos( int val );
+    int    GetEncryptKeyPos() { return encryptKeyPos; }
+    uint   PeekUInt( uint pos, int key_pos );
     bool   IsError()               { return isError; }
     void   SetError( bool value )  { isError = value; }
     bool   IsEmpty()               { return bufReadPos >= bufEndPos; }
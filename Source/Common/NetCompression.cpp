@@ -0,0 +1,236 @@
+#include "NetCompression.h"
+
+// Sequence: token (literals count in high four bits, match length minus MinMatch in low four bits),
+// count extension bytes if field is 15, literals, ushort match offset, length extension bytes
+// Last sequence of block has only literals
+
+static uint ReadUInt( const uchar* p )
+{
+    uint value;
+    memcpy( &value, p, sizeof( value ) );
+    return value;
+}
+
+static uchar* WriteLength( uchar* op, uint len )
+{
+    for( ; len >= 255; len -= 255 )
+        *op++ = 255;
+    *op++ = (uchar) len;
+    return op;
+}
+
+// Drop history older than window, when it grows twice bigger
+template< class TFunc >
+static void SlideHistory( UCharVec& history, uint len, TFunc on_shift )
+{
+    if( history.size() <= NetLz::WindowSize || history.size() + len <= NetLz::WindowSize * 2 )
+        return;
+
+    uint shift = (uint) history.size() - NetLz::WindowSize;
+    history.erase( history.begin(), history.begin() + shift );
+    on_shift( shift );
+}
+
+NetLzEncoder::NetLzEncoder()
+{
+    memzero( hashTable, sizeof( hashTable ) );
+}
+
+uint NetLzEncoder::Compress( const uchar* data, uint len, UCharVec& out, bool stored )
+{
+    RUNTIME_ASSERT( len <= NetLz::MaxBlockSize );
+
+    SlideHistory( history, len, [ this ] ( uint shift )
+                  {
+                      for( uint& pos : hashTable )
+                          pos = ( pos > shift ? pos - shift : 0 );
+                  } );
+
+    uint start = (uint) history.size();
+    history.insert( history.end(), data, data + len );
+
+    // Worst case is all literals with count extension
+    out.resize( MAX( NetLz::HeaderSize + len + len / 255 + 16, NetBuffer::DefaultBufSize ) );
+
+    uint packed = ( stored ? len : CompressBlock( start, start + len, &out[ NetLz::HeaderSize ] ) );
+    if( packed >= len )
+    {
+        memcpy( &out[ NetLz::HeaderSize ], data, len );
+        packed = len;
+    }
+
+    memcpy( &out[ 0 ], &packed, sizeof( packed ) );
+    memcpy( &out[ sizeof( packed ) ], &len, sizeof( len ) );
+    return NetLz::HeaderSize + packed;
+}
+
+uint NetLzEncoder::CompressBlock( uint start, uint end, uchar* out )
+{
+    const uchar* base = &history[ 0 ];
+    uchar*       op = out;
+    uint         ip = start;
+    uint         anchor = start;
+
+    while( ip + NetLz::MinMatch <= end )
+    {
+        uint  seq = ReadUInt( base + ip );
+        uint& entry = hashTable[ ( seq * 2654435761U ) >> ( 32 - HashLog ) ];
+        uint  ref = entry;
+        entry = ip + 1;
+
+        if( !ref || ip - ( ref - 1 ) > NetLz::WindowSize || ReadUInt( base + ref - 1 ) != seq )
+        {
+            // Skip faster through not compressible data
+            ip += 1 + ( ( ip - anchor ) >> 6 );
+            continue;
+        }
+
+        uint match = ref - 1;
+        uint match_len = NetLz::MinMatch;
+        while( ip + match_len < end && base[ match + match_len ] == base[ ip + match_len ] )
+            match_len++;
+
+        uint lit_len = ip - anchor;
+        uint ml = match_len - NetLz::MinMatch;
+        *op++ = (uchar) ( ( MIN( lit_len, 15U ) << 4 ) | MIN( ml, 15U ) );
+        if( lit_len >= 15 )
+            op = WriteLength( op, lit_len - 15 );
+        memcpy( op, base + anchor, lit_len );
+        op += lit_len;
+        ushort offset = (ushort) ( ip - match );
+        memcpy( op, &offset, sizeof( offset ) );
+        op += sizeof( offset );
+        if( ml >= 15 )
+            op = WriteLength( op, ml - 15 );
+
+        ip += match_len;
+        anchor = ip;
+    }
+
+    uint lit_len = end - anchor;
+    *op++ = (uchar) ( MIN( lit_len, 15U ) << 4 );
+    if( lit_len >= 15 )
+        op = WriteLength( op, lit_len - 15 );
+    memcpy( op, base + anchor, lit_len );
+    op += lit_len;
+    return (uint) ( op - out );
+}
+
+bool NetLzDecoder::Decompress( const uchar* data, uint len, NetBuffer& buf )
+{
+    pending.insert( pending.end(), data, data + len );
+
+    uint pos = 0;
+    while( (uint) pending.size() - pos >= NetLz::HeaderSize )
+    {
+        uint packed = ReadUInt( &pending[ pos ] );
+        uint unpacked = ReadUInt( &pending[ pos + sizeof( uint ) ] );
+        if( unpacked > NetLz::MaxBlockSize || packed > unpacked )
+            return false;
+        if( (uint) pending.size() - pos - NetLz::HeaderSize < packed )
+            break;
+
+        SlideHistory( history, unpacked, [] ( uint ) {} );
+
+        uint start = (uint) history.size();
+        history.resize( start + unpacked );
+        const uchar* block = &pending[ pos + NetLz::HeaderSize ];
+        if( packed == unpacked )
+        {
+            if( unpacked )
+                memcpy( &history[ start ], block, unpacked );
+        }
+        else if( !DecompressBlock( block, packed, start, start + unpacked ) )
+        {
+            return false;
+        }
+
+        if( unpacked )
+        {
+            buf.GrowBuf( unpacked );
+            memcpy( buf.GetData() + buf.GetEndPos(), &history[ start ], unpacked );
+            buf.SetEndPos( buf.GetEndPos() + unpacked );
+        }
+
+        pos += NetLz::HeaderSize + packed;
+    }
+
+    pending.erase( pending.begin(), pending.begin() + pos );
+    return true;
+}
+
+bool NetLzDecoder::DecompressBlock( const uchar* data, uint len, uint start, uint end )
+{
+    const uchar* ip = data;
+    const uchar* ip_end = data + len;
+    uchar*       base = &history[ 0 ];
+    uint         op = start;
+
+    while( true )
+    {
+        if( ip == ip_end )
+            return false;
+
+        uint token = *ip++;
+        uint lit_len = token >> 4;
+        if( lit_len == 15 )
+        {
+            uint b;
+            do
+            {
+                if( ip == ip_end )
+                    return false;
+                b = *ip++;
+                lit_len += b;
+            }
+            while( b == 255 );
+        }
+
+        if( lit_len > (uint) ( ip_end - ip ) || lit_len > end - op )
+            return false;
+        memcpy( base + op, ip, lit_len );
+        ip += lit_len;
+        op += lit_len;
+
+        if( ip == ip_end )
+            return op == end;
+
+        if( ip_end - ip < (int) sizeof( ushort ) )
+            return false;
+        ushort offset;
+        memcpy( &offset, ip, sizeof( offset ) );
+        ip += sizeof( offset );
+        if( !offset || offset > op )
+            return false;
+
+        uint match_len = ( token & 15 ) + NetLz::MinMatch;
+        if( ( token & 15 ) == 15 )
+        {
+            uint b;
+            do
+            {
+                if( ip == ip_end )
+                    return false;
+                b = *ip++;
+                match_len += b;
+            }
+            while( b == 255 );
+        }
+
+        if( match_len > end - op )
+            return false;
+
+        // Match may overlap bytes written by itself
+        uint from = op - offset;
+        if( offset >= match_len )
+        {
+            memcpy( base + op, base + from, match_len );
+        }
+        else
+        {
+            for( uint i = 0; i < match_len; i++ )
+                base[ op + i ] = base[ from + i ];
+        }
+        op += match_len;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef __NET_COMPRESSION__
+#define __NET_COMPRESSION__
+
+#include "Common.h"
+#include "NetBuffer.h"
+
+// Fast LZ77 codec of server to client stream, alternative to zlib when client requests it
+// Each send is one block: uint packed size, uint unpacked size, data
+// Block is stored as is if packed size equals unpacked size
+// Matches may refer to previous blocks of stream, up to WindowSize bytes back
+namespace NetLz
+{
+    const uint WindowSize = 0xFFFF;
+    const uint MinMatch = 4;
+    const uint HeaderSize = sizeof( uint ) * 2;
+    const uint MaxBlockSize = 0x4000000;
+}
+
+class NetLzEncoder
+{
+private:
+    static const uint HashLog = 12;
+
+    UCharVec history;
+    uint     hashTable[ 1 << HashLog ]; // Position in history plus one, zero for empty
+
+    uint CompressBlock( uint start, uint end, uchar* out );
+
+public:
+    NetLzEncoder();
+
+    // Writes block to output buffer, returns its size with header
+    uint Compress( const uchar* data, uint len, UCharVec& out, bool stored );
+};
+
+class NetLzDecoder
+{
+private:
+    UCharVec history;
+    UCharVec pending;
+
+    bool DecompressBlock( const uchar* data, uint len, uint start, uint end );
+
+public:
+    // Appends unpacked data of all complete blocks to buffer, incomplete block waits for next call
+    // Returns false on corrupted stream
+    bool Decompress( const uchar* data, uint len, NetBuffer& buf );
+};
+
+#endif // __NET_COMPRESSION__
@@ -0,0 +1,79 @@
+#include "NetMessages.h"
+#include "StringUtils.h"
+
+static void WriteLoginData( NetBuffer& bout, const string& name, const string& password )
+{
+    char buf[ UTF8_BUF_SIZE( MAX_NAME ) ];
+    memzero( buf, sizeof( buf ) );
+    Str::Copy( buf, name.c_str() );
+    bout.Push( buf, sizeof( buf ) );
+    memzero( buf, sizeof( buf ) );
+    Str::Copy( buf, password.c_str() );
+    bout.Push( buf, sizeof( buf ) );
+}
+
+void NetMessages::WriteLogIn( NetBuffer& bout, NetBuffer& bin, const string& name, const string& password, uint lang )
+{
+    bout << NETMSG_LOGIN;
+    bout << (ushort) FONLINE_VERSION;
+
+    // Begin data encrypting
+    bout.SetEncryptKey( 12345 );
+    bin.SetEncryptKey( 12345 );
+
+    WriteLoginData( bout, name, password );
+    bout << lang;
+}
+
+void NetMessages::WriteCreatePlayer( NetBuffer& bout, NetBuffer& bin, const string& name, const string& password )
+{
+    uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( ushort ) + UTF8_BUF_SIZE( MAX_NAME ) * 2;
+
+    bout << NETMSG_CREATE_CLIENT;
+    bout << msg_len;
+
+    bout << (ushort) FONLINE_VERSION;
+
+    // Begin data encrypting
+    bout.SetEncryptKey( 1234567890 );
+    bin.SetEncryptKey( 1234567890 );
+
+    WriteLoginData( bout, name, password );
+}
+
+void NetMessages::WriteText( NetBuffer& bout, const string& text, uchar how_say )
+{
+    ushort len = (ushort) text.length();
+    uint   msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( how_say ) + sizeof( len ) + len;
+
+    bout << NETMSG_SEND_TEXT;
+    bout << msg_len;
+    bout << how_say;
+    bout << len;
+    bout.Push( text.c_str(), len );
+}
+
+void NetMessages::WritePing( NetBuffer& bout, uchar ping )
+{
+    bout << NETMSG_PING;
+    bout << ping;
+}
+
+void NetMessages::WriteLoadMapOk( NetBuffer& bout )
+{
+    bout << NETMSG_SEND_LOAD_MAP_OK;
+}
+
+void NetMessages::WriteMove( NetBuffer& bout, bool run, uint move_params, ushort hx, ushort hy )
+{
+    bout << ( run ? NETMSG_SEND_MOVE_RUN : NETMSG_SEND_MOVE_WALK );
+    bout << move_params;
+    bout << hx;
+    bout << hy;
+}
+
+void NetMessages::WriteCompression( NetBuffer& bout, uchar codec )
+{
+    bout << NETMSG_COMPRESSION;
+    bout << codec;
+}
@@ -0,0 +1,21 @@
+#ifndef __NET_MESSAGES__
+#define __NET_MESSAGES__
+
+#include "Common.h"
+#include "NetBuffer.h"
+
+// Layouts of messages sent from client to server, shared by game client and bots
+namespace NetMessages
+{
+    // Both begin data encrypting, so input buffer key is changed too
+    void WriteLogIn( NetBuffer& bout, NetBuffer& bin, const string& name, const string& password, uint lang );
+    void WriteCreatePlayer( NetBuffer& bout, NetBuffer& bin, const string& name, const string& password );
+
+    void WriteText( NetBuffer& bout, const string& text, uchar how_say );
+    void WritePing( NetBuffer& bout, uchar ping );
+    void WriteLoadMapOk( NetBuffer& bout );
+    void WriteMove( NetBuffer& bout, bool run, uint move_params, ushort hx, ushort hy );
+    void WriteCompression( NetBuffer& bout, uchar codec );
+};
+
+#endif // __NET_MESSAGES__
@@ -69,6 +69,16 @@
 // uchar ping (see Ping in FOdefines.h)
 // ////////////////////////////////////////////////////////////////////////
 
+#define NETMSG_COMPRESSION                  MAKE_NETMSG_HEADER( 6 )
+#define NETMSG_COMPRESSION_SIZE             ( sizeof( uint ) + sizeof( uchar ) )
+#define NET_COMPRESSION_ZLIB                ( 0 )
+#define NET_COMPRESSION_LZ                  ( 1 )
+// ////////////////////////////////////////////////////////////////////////
+// Codec of data sent from server to client, must be first message of connection
+// Without this message zlib is used
+// uchar codec
+// ////////////////////////////////////////////////////////////////////////
+
 #define NETMSG_END_PARSE_TO_GAME            MAKE_NETMSG_HEADER( 7 )
 #define NETMSG_END_PARSE_TO_GAME_SIZE       ( sizeof( uint ) )
 // ////////////////////////////////////////////////////////////////////////
@@ -88,14 +98,22 @@
 // ////////////////////////////////////////////////////////////////////////
 
 #define NETMSG_UPDATE_FILES_LIST            MAKE_NETMSG_HEADER( 15 )
+#define UPDATE_FILES_LIST_VERSION           ( 3 )
 // ////////////////////////////////////////////////////////////////////////
 // Files list to update
 // uint msg_len
 // bool outdated
-// uint files_count
+// uint list_size
+//   uint list_version
 //   short path_len
 //   char path[path_len]
 //   uint size
+//   uint hash
+//   uint chunks_count
+//     uint chunk_size
+//     uint chunk_hash
+//   ...
+//   short -1
 // Properties global
 // ////////////////////////////////////////////////////////////////////////
 
@@ -113,10 +131,19 @@
 // ////////////////////////////////////////////////////////////////////////
 
 #define NETMSG_UPDATE_FILE_DATA             MAKE_NETMSG_HEADER( 18 )
-#define NETMSG_UPDATE_FILE_DATA_SIZE        ( sizeof( uint ) + FILE_UPDATE_PORTION )
 // ////////////////////////////////////////////////////////////////////////
-// Portion of data
-// uchar data[FILE_UPDATE_PORTION]
+// Portion of data, last portion is not padded
+// uint msg_len
+// uchar data[msg_len - header - msg_len], up to FILE_UPDATE_PORTION
+// ////////////////////////////////////////////////////////////////////////
+
+#define NETMSG_GET_UPDATE_FILE_PART         MAKE_NETMSG_HEADER( 19 )
+#define NETMSG_GET_UPDATE_FILE_PART_SIZE    ( sizeof( uint ) + sizeof( uint ) * 3 )
+// ////////////////////////////////////////////////////////////////////////
+// Request to range of updated file, data sent by portions as for whole file
+// uint file_number
+// uint offset
+// uint size
 // ////////////////////////////////////////////////////////////////////////
 
 // ************************************************************************
@@ -16,6 +16,33 @@ Property::Property()
     nativeSendCallback = nullptr;
     nativeSetCallback = nullptr;
     setCallbacksAnyNewValue = false;
+    memzero( spareArrays, sizeof( spareArrays ) );
+    spareArrayNext = 0;
+}
+
+CScriptArray* Property::AcquireArray( uint size )
+{
+    // Reuse array of previous calls if nobody holds it anymore
+    for( CScriptArray* spare : spareArrays )
+    {
+        if( spare && spare->GetRefCount() == 1 )
+        {
+            spare->Resize( size );
+            spare->AddRef();
+            return spare;
+        }
+    }
+
+    // All held by scripts, new one replaces oldest
+    CScriptArray* arr = CScriptArray::Create( asObjType, size );
+    RUNTIME_ASSERT( arr );
+    arr->AddRef();
+    CScriptArray*& slot = spareArrays[ spareArrayNext ];
+    spareArrayNext = ( spareArrayNext + 1 ) % SpareArraysCount;
+    if( slot )
+        slot->Release();
+    slot = arr;
+    return arr;
 }
 
 void* Property::CreateRefValue( uchar* data, uint data_size )
@@ -30,8 +57,7 @@ void* Property::CreateRefValue( uchar* data, uint data_size )
                 uint arr_size;
                 memcpy( &arr_size, data, sizeof( arr_size ) );
                 data += sizeof( uint );
-                CScriptArray* arr = CScriptArray::Create( asObjType, arr_size );
-                RUNTIME_ASSERT( arr );
+                CScriptArray* arr = AcquireArray( arr_size );
                 for( uint i = 0; i < arr_size; i++ )
                 {
                     uint str_size;
@@ -45,17 +71,14 @@ void* Property::CreateRefValue( uchar* data, uint data_size )
             }
             else
             {
-                CScriptArray* arr = CScriptArray::Create( asObjType );
-                RUNTIME_ASSERT( arr );
-                return arr;
+                return AcquireArray( 0 );
             }
         }
         else
         {
             uint          element_size = engine->GetSizeOfPrimitiveType( asObjType->GetSubTypeId() );
             uint          arr_size = data_size / element_size;
-            CScriptArray* arr = CScriptArray::Create( asObjType, arr_size );
-            RUNTIME_ASSERT( arr );
+            CScriptArray* arr = AcquireArray( arr_size );
             if( arr_size )
                 memcpy( arr->At( 0 ), data, arr_size * element_size );
             return arr;
@@ -1777,7 +1800,7 @@ DataBase::Document Properties::SaveToDbDocument( Properties* base )
             }
         }
 
-        doc.insert( std::make_pair( prop->propName, SavePropertyToDbValue( prop ) ) );
+        doc.emplace( prop->propName, SavePropertyToDbValue( prop ) );
     }
 
     return doc;
@@ -2551,7 +2574,7 @@ DataBase::Value Properties::SavePropertyToDbValue( Property* prop )
         DataBase::Dict dict;
         if( data_size )
         {
-            auto get_key_string = [] ( void* p, int type_id, string type_name, bool is_hash )->string
+            auto get_key_string = [] ( void* p, int type_id, const string& type_name, bool is_hash )->string
             {
                 if( is_hash )
                     return _str().parseHash( *(hash*) p ).str();
@@ -2681,7 +2704,7 @@ DataBase::Value Properties::SavePropertyToDbValue( Property* prop )
             {
                 int value_type_id = prop->asObjType->GetSubTypeId( 1 );
                 uint value_element_size = prop->asObjType->GetEngine()->GetSizeOfPrimitiveType( value_type_id );
-                string     value_element_type_name = prop->asObjType->GetSubType( 1 ) ? prop->asObjType->GetSubType( 1 )->GetName() : "";
+                string value_element_type_name = prop->asObjType->GetSubType( 1 ) ? prop->asObjType->GetSubType( 1 )->GetName() : "";
                 uint whole_element_size = key_element_size + value_element_size;
                 uint dict_size = data_size / whole_element_size;
                 for( uint i = 0; i < dict_size; i++ )
@@ -2926,6 +2949,8 @@ PropertyRegistrator::~PropertyRegistrator()
 
     for( size_t i = 0; i < registeredProperties.size(); i++ )
     {
+        for( CScriptArray*& spare : registeredProperties[ i ]->spareArrays )
+            SAFEREL( spare );
         SAFEREL( registeredProperties[ i ]->asObjType );
         SAFEDEL( registeredProperties[ i ] );
     }
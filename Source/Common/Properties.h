@@ -10,39 +10,55 @@
 # include "DataBase.h"
 #endif
 
-#define PROPERTIES_HEADER()                                          \
-    static PropertyRegistrator * PropertiesRegistrator;              \
-    static vector< pair< const char*, Property** > > PropertiesList; \
+#define PROPERTIES_HEADER()                                                       \
+    static PropertyRegistrator * PropertiesRegistrator;                           \
+    static vector< tuple< const char*, Property**, uint, bool > > PropertiesList; \
     static void SetPropertyRegistrator( PropertyRegistrator * registrator )
 
-#define PROPERTIES_IMPL( class_name )                                             \
-    PropertyRegistrator * class_name::PropertiesRegistrator;                      \
-    vector< pair< const char*, Property** > > class_name::PropertiesList;         \
-    void class_name::SetPropertyRegistrator( PropertyRegistrator * registrator )  \
-    {                                                                             \
-        PropertiesRegistrator = registrator;                                      \
-        PropertiesRegistrator->FinishRegistration();                              \
-        for( auto it = PropertiesList.begin(); it != PropertiesList.end(); it++ ) \
-        {                                                                         \
-            *it->second = PropertiesRegistrator->Find( it->first );               \
-            RUNTIME_ASSERT_STR( *it->second, it->first );                         \
-        }                                                                         \
+#define PROPERTIES_IMPL( class_name )                                                                    \
+    PropertyRegistrator * class_name::PropertiesRegistrator;                                             \
+    vector< tuple< const char*, Property**, uint, bool > > class_name::PropertiesList;                   \
+    void class_name::SetPropertyRegistrator( PropertyRegistrator * registrator )                         \
+    {                                                                                                    \
+        PropertiesRegistrator = registrator;                                                             \
+        PropertiesRegistrator->FinishRegistration();                                                     \
+        for( auto it = PropertiesList.begin(); it != PropertiesList.end(); it++ )                        \
+        {                                                                                                \
+            Property*& prop = *std::get< 1 >( *it );                                                     \
+            prop = PropertiesRegistrator->Find( std::get< 0 >( *it ) );                                  \
+            RUNTIME_ASSERT_STR( prop, std::get< 0 >( *it ) );                                            \
+            RUNTIME_ASSERT_STR( prop->GetBaseSize() == std::get< 2 >( *it ), std::get< 0 >( *it ) );     \
+            RUNTIME_ASSERT_STR( !std::get< 3 >( *it ) || !( prop->GetAccess() & Property::VirtualMask ), \
+                                std::get< 0 >( *it ) );                                                  \
+        }                                                                                                \
     }
 
+// Arithmetic values are loaded directly from entity data, see Property::GetClassValue
+// Properties with script get callback must be declared by CLASS_VIRTUAL_PROPERTY, checked at registrator assignment
 #define CLASS_PROPERTY( prop_type, prop )                                                                       \
     static Property * Property ## prop;                                                                         \
+    static constexpr bool Property ## prop ## IsRaw() { return std::is_arithmetic< prop_type >::value; }        \
+    inline prop_type Get ## prop() { return Property ## prop->GetClassValue< prop_type >( this ); }             \
+    inline void      Set ## prop( prop_type value ) { Property ## prop->SetValue< prop_type >( this, value ); } \
+    inline bool      IsNonEmpty ## prop() { uint data_size = 0; Property ## prop->GetRawData( this, data_size ); return data_size > 0; }
+
+#define CLASS_VIRTUAL_PROPERTY( prop_type, prop )                                                               \
+    static Property * Property ## prop;                                                                         \
+    static constexpr bool Property ## prop ## IsRaw() { return false; }                                         \
     inline prop_type Get ## prop() { return Property ## prop->GetValue< prop_type >( this ); }                  \
     inline void      Set ## prop( prop_type value ) { Property ## prop->SetValue< prop_type >( this, value ); } \
     inline bool      IsNonEmpty ## prop() { uint data_size = 0; Property ## prop->GetRawData( this, data_size ); return data_size > 0; }
 
-#define CLASS_PROPERTY_IMPL( class_name, prop )                                                              \
-    Property * class_name::Property ## prop;                                                                 \
-    struct _ ## class_name ## Property ## prop ## Initializer                                                \
-    {                                                                                                        \
-        _ ## class_name ## Property ## prop ## Initializer()                                                 \
-        {                                                                                                    \
-            class_name::PropertiesList.push_back( std::make_pair( # prop, &class_name::Property ## prop ) ); \
-        }                                                                                                    \
+#define CLASS_PROPERTY_IMPL( class_name, prop )                                                                                     \
+    Property * class_name::Property ## prop;                                                                                        \
+    struct _ ## class_name ## Property ## prop ## Initializer                                                                       \
+    {                                                                                                                               \
+        _ ## class_name ## Property ## prop ## Initializer()                                                                        \
+        {                                                                                                                           \
+            class_name::PropertiesList.push_back( std::make_tuple( # prop, &class_name::Property ## prop,                           \
+                                                                   (uint) sizeof( std::declval< class_name >().Get ## prop() ),     \
+                                                                   class_name::Property ## prop ## IsRaw() ) );                     \
+        }                                                                                                                           \
     } _ ## class_name ## Property ## prop ## Initializer
 
 class asITypeInfo;
@@ -119,6 +135,24 @@ public:
         return ret_value;
     }
 
+    // Getters of class properties, type size is checked once at registrator assignment
+    // Arithmetic value is plain load from entity data, property is not virtual by CLASS_PROPERTY declaration
+    // Destroyed entity keeps its data until deletion, so last value is returned instead of script error
+    template< typename T, class TEntity >
+    typename std::enable_if< std::is_arithmetic< T >::value, T >::type GetClassValue( TEntity* entity )
+    {
+        T value;
+        memcpy( &value, &entity->Props.podData[ podDataOffset ], sizeof( T ) );
+        return value;
+    }
+
+    // Strings and containers go through generic path
+    template< typename T, class TEntity >
+    typename std::enable_if< !std::is_arithmetic< T >::value, T >::type GetClassValue( TEntity* entity )
+    {
+        return GetValue< T >( entity );
+    }
+
     template< typename T >
     void SetValue( Entity* entity, T new_value )
     {
@@ -143,13 +177,14 @@ private:
     };
 
     Property();
-    void*  CreateRefValue( uchar* data, uint data_size );
-    void   ReleaseRefValue( void* value );
-    uchar* ExpandComplexValueData( void* pvalue, uint& data_size, bool& need_delete );
-    void   GenericGet( Entity* entity, void* ret_value );
-    void   GenericSet( Entity* entity, void* new_value );
-    uchar* GetPropRawData( Properties* properties, uint& data_size );
-    void   SetPropRawData( Properties* properties, uchar* data, uint data_size );
+    void*         CreateRefValue( uchar* data, uint data_size );
+    CScriptArray* AcquireArray( uint size );
+    void          ReleaseRefValue( void* value );
+    uchar*        ExpandComplexValueData( void* pvalue, uint& data_size, bool& need_delete );
+    void          GenericGet( Entity* entity, void* ret_value );
+    void          GenericSet( Entity* entity, void* new_value );
+    uchar*        GetPropRawData( Properties* properties, uint& data_size );
+    void          SetPropRawData( Properties* properties, uchar* data, uint data_size );
 
     // Static data
     string       propName;
@@ -199,6 +234,14 @@ private:
     bool                 setCallbacksAnyNewValue;
     NativeCallback       nativeSetCallback;
     NativeSendCallback   nativeSendCallback;
+
+    // Arrays returned by last gets, reused by next get of any entity after scripts released them
+    // Scripts keep got arrays only for a while in local handles, so few per property is enough
+    // Per entity cache would keep objects of all entities alive and can't see script changes in returned array
+    // Dicts are not reused, refill allocates all their nodes anyway
+    static const uint    SpareArraysCount = 4;
+    CScriptArray*        spareArrays[ SpareArraysCount ];
+    uint                 spareArrayNext;
 };
 typedef vector< Property* > PropertyVec;
 
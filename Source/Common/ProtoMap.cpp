@@ -52,6 +52,7 @@ ProtoMap::~ProtoMap()
     for( auto it = StaticItemsVec.begin(), end = StaticItemsVec.end(); it != end; ++it )
         SAFEREL( *it );
     StaticItemsVec.clear();
+    StaticItemsGrid.Clear();
     for( auto it = TriggerItemsVec.begin(), end = TriggerItemsVec.end(); it != end; ++it )
         SAFEREL( *it );
     TriggerItemsVec.clear();
@@ -198,6 +199,7 @@ static bool OnAfterLoad( ProtoMap& pmap, EntityVec& entities )
     ushort maxhy = pmap.GetHeight();
     pmap.HexFlags = new uchar[ maxhx * maxhy ];
     memzero( pmap.HexFlags, maxhx * maxhy );
+    pmap.StaticItemsGrid.Init( maxhx, maxhy );
 
     uint     scenery_count = 0;
     UCharVec scenery_data;
@@ -238,6 +240,7 @@ static bool OnAfterLoad( ProtoMap& pmap, EntityVec& entities )
         {
             item->AddRef();
             pmap.StaticItemsVec.push_back( item );
+            pmap.StaticItemsGrid.Add( item, hx, hy );
         }
 
         if( !item->GetIsNoBlock() )
@@ -1083,24 +1086,28 @@ void ProtoMap::GetStaticItemTriggers( ushort hx, ushort hy, ItemVec& triggers )
 
 Item* ProtoMap::GetStaticItem( ushort hx, ushort hy, hash pid )
 {
-    for( auto& item : StaticItemsVec )
-        if( ( !pid || item->GetProtoId() == pid ) && item->GetHexX() == hx && item->GetHexY() == hy )
-            return item;
-    return nullptr;
+    ItemVec hex_items;
+    StaticItemsGrid.Collect( hx, hy, 0, hex_items, [ hx, hy, pid ] ( Item * item )
+                             {
+                                 return ( !pid || item->GetProtoId() == pid ) && item->GetHexX() == hx && item->GetHexY() == hy;
+                             } );
+    return !hex_items.empty() ? hex_items.front() : nullptr;
 }
 
 void ProtoMap::GetStaticItemsHex( ushort hx, ushort hy, ItemVec& items )
 {
-    for( auto& item : StaticItemsVec )
-        if( item->GetHexX() == hx && item->GetHexY() == hy )
-            items.push_back( item );
+    StaticItemsGrid.Collect( hx, hy, 0, items, [ hx, hy ] ( Item * item )
+                             {
+                                 return item->GetHexX() == hx && item->GetHexY() == hy;
+                             } );
 }
 
 void ProtoMap::GetStaticItemsHexEx( ushort hx, ushort hy, uint radius, hash pid, ItemVec& items )
 {
-    for( auto& item : StaticItemsVec )
-        if( ( !pid || item->GetProtoId() == pid ) && DistGame( item->GetHexX(), item->GetHexY(), hx, hy ) <= radius )
-            items.push_back( item );
+    StaticItemsGrid.Collect( hx, hy, radius, items, [ hx, hy, radius, pid ] ( Item * item )
+                             {
+                                 return ( !pid || item->GetProtoId() == pid ) && DistGame( item->GetHexX(), item->GetHexY(), hx, hy ) <= radius;
+                             } );
 }
 
 void ProtoMap::GetStaticItemsByPid( hash pid, ItemVec& items )
@@ -5,6 +5,7 @@
 #include "StringUtils.h"
 #include "FileUtils.h"
 #include "IniFile.h"
+#include "Crypt.h"
 #include "AngelScriptExt/reflection.h"
 #include "preprocessor.h"
 #include "scriptstdstring/scriptstdstring.h"
@@ -79,6 +80,41 @@ static BindFunctionVec   BindedFunctions;
 static HashIntMap        ScriptFuncBinds;  // Func Num -> Bind Id
 static bool              LoadLibraryCompiler = false;
 static ExceptionCallback OnException;
+static StrVec            ActiveDefines;    // Preprocessor defines, for bytecode cache key
+
+// Wrapper of JIT compiler from external library, owns compiler and library
+// Engine ships no compiler, this is only extension point for third party one
+class JitCompilerProxy: public asIJITCompiler
+{
+public:
+    asIJITCompiler* Compiler;
+    void*           Dll;
+    uint            CompiledFunctions;
+    uint            InterpretedFunctions;
+
+    JitCompilerProxy( asIJITCompiler* compiler, void* dll ): Compiler( compiler ), Dll( dll ), CompiledFunctions( 0 ), InterpretedFunctions( 0 ) {}
+
+    virtual ~JitCompilerProxy() override
+    {
+        delete Compiler;
+        DLL_Free( Dll );
+    }
+
+    virtual int CompileFunction( asIScriptFunction* function, asJITFunction* output ) override
+    {
+        int r = Compiler->CompileFunction( function, output );
+        if( r >= 0 && *output )
+            CompiledFunctions++;
+        else
+            InterpretedFunctions++;
+        return r;
+    }
+
+    virtual void ReleaseJITFunction( asJITFunction func ) override
+    {
+        Compiler->ReleaseJITFunction( func );
+    }
+};
 
 // Contexts
 struct ContextData
@@ -336,6 +372,7 @@ void Script::Finish()
 
     Preprocessor::SetPragmaCallback( nullptr );
     Preprocessor::UndefAll();
+    ActiveDefines.clear();
     UnloadScripts();
 
     while( !BusyContexts.empty() )
@@ -484,6 +521,69 @@ void Script::SetLoadLibraryCompiler( bool enabled )
     LoadLibraryCompiler = enabled;
 }
 
+bool Script::InitJitCompiler( const string& dll_name )
+{
+    RUNTIME_ASSERT( Engine->GetModuleCount() == 0 );
+
+    EngineData* edata = (EngineData*) Engine->GetUserData();
+    RUNTIME_ASSERT( !edata->JitCompiler );
+    if( edata->Profiler )
+    {
+        WriteLog( "JIT compiler '{}' skipped, not compatible with profiler.\n", dll_name );
+        return true;
+    }
+
+    string dll_path = dll_name;
+    if( _str( dll_path ).getFileExtension().empty() )
+    {
+        #ifdef FO_WINDOWS
+        dll_path += ".dll";
+        #else
+        dll_path += ".so";
+        #endif
+    }
+
+    void* dll = DLL_Load( dll_path );
+    if( !dll )
+    {
+        WriteLog( "Unable to load JIT compiler '{}', error {}.\n", dll_path, DLL_Error() );
+        return false;
+    }
+
+    typedef asIJITCompiler* ( *CreateJitCompilerFunc )( asIScriptEngine* );
+    CreateJitCompilerFunc create_func = (CreateJitCompilerFunc) DLL_GetAddress( dll, "CreateJitCompiler" );
+    asIJITCompiler*       compiler = ( create_func ? create_func( Engine ) : nullptr );
+    if( !compiler )
+    {
+        WriteLog( "JIT compiler '{}' not created, 'CreateJitCompiler' {}.\n", dll_path, create_func ? "failed" : "not found" );
+        DLL_Free( dll );
+        return false;
+    }
+
+    // Compiler hooks into bytecode through JitEntry instructions
+    JitCompilerProxy* jit = new JitCompilerProxy( compiler, dll );
+    int               r = Engine->SetEngineProperty( asEP_INCLUDE_JIT_INSTRUCTIONS, true );
+    if( r >= 0 )
+        r = Engine->SetJITCompiler( jit );
+    if( r < 0 )
+    {
+        WriteLog( "Unable to set JIT compiler '{}', error {}.\n", dll_path, r );
+        Engine->SetEngineProperty( asEP_INCLUDE_JIT_INSTRUCTIONS, false );
+        delete jit;
+        return false;
+    }
+
+    edata->JitCompiler = jit;
+    WriteLog( "JIT compiler '{}' enabled.\n", dll_path );
+
+    // Watcher aborts context, but native code checks abort only if compiler returns to interpreter
+    #ifdef SCRIPT_WATCHER
+    if( GameOpt.ScriptRunSuspendTimeout )
+        WriteLog( "Warning! Script run timeout {} ms may not stop JIT compiled functions.\n", GameOpt.ScriptRunSuspendTimeout );
+    #endif
+    return true;
+}
+
 void Script::UnloadScripts()
 {
     for( asUINT i = 0, j = Engine->GetModuleCount(); i < j; i++ )
@@ -501,13 +601,228 @@ void Script::UnloadScripts()
         Engine->GetModuleByIndex( 0 )->Discard();
 }
 
+static void SetGlobalPropertiesFromConfig()
+{
+    const StrMap& config = MainConfig->GetApp( "" );
+    for( auto& kv : config )
+    {
+        // Skip defines
+        if( kv.first.length() > 2 && kv.first[ 0 ] == '-' && kv.first[ 1 ] == '-' )
+            continue;
+
+        // Find property, with prefix and without
+        int index = Engine->GetGlobalPropertyIndexByName( ( "__" + kv.first ).c_str() );
+        if( index < 0 )
+        {
+            index = Engine->GetGlobalPropertyIndexByName( kv.first.c_str() );
+            if( index < 0 )
+                continue;
+        }
+
+        int   type_id;
+        void* ptr;
+        int   r = Engine->GetGlobalPropertyByIndex( index, nullptr, nullptr, &type_id, nullptr, nullptr, &ptr, nullptr );
+        RUNTIME_ASSERT( r >= 0 );
+
+        // Try set value
+        asITypeInfo* obj_type = ( type_id & asTYPEID_MASK_OBJECT ? Engine->GetTypeInfoById( type_id ) : nullptr );
+        bool         is_hashes[] = { false, false, false, false };
+        uchar        pod_buf[ 8 ];
+        bool         is_error = false;
+        void*        value = ReadValue( kv.second.c_str(), type_id, obj_type, is_hashes, 0, pod_buf, is_error );
+        if( !is_error )
+        {
+            if( !obj_type )
+            {
+                memcpy( ptr, value, Engine->GetSizeOfPrimitiveType( type_id ) );
+            }
+            else if( type_id & asTYPEID_OBJHANDLE )
+            {
+                if( *(void**) ptr )
+                    Engine->ReleaseScriptObject( *(void**) ptr, obj_type );
+                *(void**) ptr = value;
+            }
+            else
+            {
+                Engine->AssignScriptObject( ptr, value, obj_type );
+                Engine->ReleaseScriptObject( value, obj_type );
+            }
+        }
+    }
+}
+
+// Server scripts bytecode cache
+#define SCRIPTS_CACHE_FNAME        "Cache/ServerScripts.fobc"
+#define SCRIPTS_CACHE_SIGNATURE    ( 0x46534243 )   // FOBC
+
+static uint64 GetScriptsCacheKey( const string& target, const ScriptEntryVec& scripts )
+{
+    // Sources, defines and registered engine interface, all that affects compiled bytecode
+    string key_data = _str( "{} {} {} {}\n", target, FONLINE_VERSION, ANGELSCRIPT_VERSION_STRING, Engine->GetEngineProperty( asEP_INCLUDE_JIT_INSTRUCTIONS ) );
+    for( auto& script : scripts )
+        key_data += script.Name + "\n" + script.Content + "\n";
+    for( auto& define : ActiveDefines )
+        key_data += define + "\n";
+    for( auto& kv : MainConfig->GetApp( "" ) )
+    {
+        if( kv.first.length() > 2 && kv.first[ 0 ] == '-' && kv.first[ 1 ] == '-' )
+            key_data += kv.first + "\n";
+    }
+
+    for( asUINT i = 0, j = Engine->GetObjectTypeCount(); i < j; i++ )
+    {
+        asITypeInfo* type = Engine->GetObjectTypeByIndex( i );
+        key_data += _str( "{} {}\n", Engine->GetTypeDeclaration( type->GetTypeId(), true ), type->GetFlags() ).str();
+        for( asUINT k = 0, l = type->GetBehaviourCount(); k < l; k++ )
+        {
+            asEBehaviours      beh;
+            asIScriptFunction* beh_func = type->GetBehaviourByIndex( k, &beh );
+            key_data += _str( "{} {}\n", (int) beh, beh_func->GetDeclaration( true, true, true ) ).str();
+        }
+        for( asUINT k = 0, l = type->GetFactoryCount(); k < l; k++ )
+            key_data += _str( "{}\n", type->GetFactoryByIndex( k )->GetDeclaration( true, true, true ) ).str();
+        for( asUINT k = 0, l = type->GetMethodCount(); k < l; k++ )
+            key_data += _str( "{}\n", type->GetMethodByIndex( k )->GetDeclaration( true, true, true ) ).str();
+        for( asUINT k = 0, l = type->GetPropertyCount(); k < l; k++ )
+            key_data += _str( "{}\n", type->GetPropertyDeclaration( k, true ) ).str();
+    }
+    for( asUINT i = 0, j = Engine->GetGlobalFunctionCount(); i < j; i++ )
+        key_data += _str( "{}\n", Engine->GetGlobalFunctionByIndex( i )->GetDeclaration( true, true, true ) ).str();
+    for( asUINT i = 0, j = Engine->GetGlobalPropertyCount(); i < j; i++ )
+    {
+        const char* name;
+        const char* ns;
+        int         type_id;
+        bool        is_const;
+        Engine->GetGlobalPropertyByIndex( i, &name, &ns, &type_id, &is_const );
+        key_data += _str( "{}{} {}::{}\n", is_const ? "const " : "", Engine->GetTypeDeclaration( type_id, true ), ns, name ).str();
+    }
+    for( asUINT i = 0, j = Engine->GetEnumCount(); i < j; i++ )
+    {
+        asITypeInfo* enum_type = Engine->GetEnumByIndex( i );
+        key_data += _str( "{}\n", Engine->GetTypeDeclaration( enum_type->GetTypeId(), true ) ).str();
+        for( asUINT k = 0, l = enum_type->GetEnumValueCount(); k < l; k++ )
+        {
+            int         value;
+            const char* value_name = enum_type->GetEnumValueByIndex( k, &value );
+            key_data += _str( "{}={}\n", value_name, value ).str();
+        }
+    }
+    for( asUINT i = 0, j = Engine->GetFuncdefCount(); i < j; i++ )
+        key_data += _str( "{}\n", Engine->GetFuncdefByIndex( i )->GetFuncdefSignature()->GetDeclaration( true, true, true ) ).str();
+    for( asUINT i = 0, j = Engine->GetTypedefCount(); i < j; i++ )
+    {
+        asITypeInfo* typedef_type = Engine->GetTypedefByIndex( i );
+        key_data += _str( "{} {}\n", typedef_type->GetName(), Engine->GetTypeDeclaration( typedef_type->GetTypedefTypeId(), true ) ).str();
+    }
+
+    return Crypt.MurmurHash2_64( (const uchar*) key_data.c_str(), (uint) key_data.length() );
+}
+
+static bool LoadScriptsCache( uint64 cache_key, Pragmas& pragmas, UCharVec& bytecode, UCharVec& lnt_data )
+{
+    File cache;
+    if( !cache.LoadFile( File::GetWritePath( SCRIPTS_CACHE_FNAME ) ) )
+        return false;
+
+    if( cache.GetBEUInt() != SCRIPTS_CACHE_SIGNATURE )
+    {
+        WriteLog( "Invalid scripts bytecode cache signature.\n" );
+        return false;
+    }
+
+    uint64 key = (uint64) cache.GetBEUInt() << 32;
+    key |= cache.GetBEUInt();
+    if( key != cache_key )
+    {
+        WriteLog( "Scripts bytecode cache outdated.\n" );
+        return false;
+    }
+
+    // Verified before pragmas replaying, after it no way to discard registered engine entries
+    uint64 data_hash = (uint64) cache.GetBEUInt() << 32;
+    data_hash |= cache.GetBEUInt();
+    if( cache.GetCurPos() > cache.GetFsize() || data_hash != Crypt.MurmurHash2_64( cache.GetCurBuf(), cache.GetFsize() - cache.GetCurPos() ) )
+    {
+        WriteLog( "Scripts bytecode cache corrupted.\n" );
+        return false;
+    }
+
+    uint pragmas_count = cache.GetBEUInt();
+    for( uint i = 0; i < pragmas_count; i++ )
+    {
+        Preprocessor::PragmaInstance pragma;
+        pragma.Name = cache.GetStrNT();
+        pragma.Text = cache.GetStrNT();
+        pragma.CurrentFile = cache.GetStrNT();
+        pragmas.push_back( pragma );
+    }
+
+    bytecode.resize( cache.GetBEUInt() );
+    lnt_data.resize( bytecode.empty() || !cache.CopyMem( &bytecode[ 0 ], (uint) bytecode.size() ) ? 0 : cache.GetBEUInt() );
+    if( lnt_data.empty() || !cache.CopyMem( &lnt_data[ 0 ], (uint) lnt_data.size() ) || !cache.IsEOF() )
+    {
+        WriteLog( "Scripts bytecode cache truncated.\n" );
+        return false;
+    }
+    return true;
+}
+
+static void SaveScriptsCache( uint64 cache_key )
+{
+    EngineData*      edata = (EngineData*) Engine->GetUserData();
+    asIScriptModule* module = Engine->GetModuleByIndex( 0 );
+    CBytecodeStream  binary;
+    if( module->SaveByteCode( &binary ) < 0 )
+    {
+        WriteLog( "Unable to save scripts bytecode to cache.\n" );
+        return;
+    }
+
+    std::vector< asBYTE >&              buf = binary.GetBuf();
+    UCharVec                            lnt_data;
+    Preprocessor::LineNumberTranslator* lnt = (Preprocessor::LineNumberTranslator*) module->GetUserData();
+    Preprocessor::StoreLineNumberTranslator( lnt, lnt_data );
+
+    File           data;
+    const Pragmas& pragmas = edata->PragmaCB->GetProcessedPragmas();
+    data.SetBEUInt( (uint) pragmas.size() );
+    for( auto& pragma : pragmas )
+    {
+        data.SetStrNT( pragma.Name );
+        data.SetStrNT( pragma.Text );
+        data.SetStrNT( pragma.CurrentFile );
+    }
+    data.SetBEUInt( (uint) buf.size() );
+    data.SetData( &buf[ 0 ], (uint) buf.size() );
+    data.SetBEUInt( (uint) lnt_data.size() );
+    data.SetData( &lnt_data[ 0 ], (uint) lnt_data.size() );
+
+    File   cache;
+    uint64 data_hash = Crypt.MurmurHash2_64( data.GetOutBuf(), data.GetOutBufLen() );
+    cache.SetBEUInt( SCRIPTS_CACHE_SIGNATURE );
+    cache.SetBEUInt( (uint) ( cache_key >> 32 ) );
+    cache.SetBEUInt( (uint) cache_key );
+    cache.SetBEUInt( (uint) ( data_hash >> 32 ) );
+    cache.SetBEUInt( (uint) data_hash );
+    cache.SetData( data.GetOutBuf(), data.GetOutBufLen() );
+    if( !cache.SaveFile( SCRIPTS_CACHE_FNAME ) )
+        WriteLog( "Unable to write scripts bytecode cache '{}'.\n", SCRIPTS_CACHE_FNAME );
+}
+
 bool Script::ReloadScripts( const string& target )
 {
     WriteLog( "Reload scripts...\n" );
 
+    double start_tick = Timer::AccurateTick();
     Script::UnloadScripts();
 
     EngineData* edata = (EngineData*) Engine->GetUserData();
+    if( edata->JitCompiler )
+    {
+        edata->JitCompiler->CompiledFunctions = 0;
+        edata->JitCompiler->InterpretedFunctions = 0;
+    }
 
     // Combine scripts
     FileCollection fos_files( "fos" );
@@ -576,17 +891,55 @@ bool Script::ReloadScripts( const string& target )
         return false;
     }
 
+    // Bytecode cache, profiler needs preprocessed sources
+    bool   use_cache = ( target == "Server" && !edata->Profiler && MainConfig->GetInt( "", "ScriptBytecodeCache", 0 ) != 0 );
+    uint64 cache_key = ( use_cache ? GetScriptsCacheKey( target, scripts ) : 0 );
+    bool   cache_loaded = false;
+    bool   pragmas_called = false;
+    if( use_cache && !MainConfig->GetInt( "", "ScriptBytecodeCacheRebuild", 0 ) )
+    {
+        Pragmas  pragmas;
+        UCharVec bytecode;
+        UCharVec lnt_data;
+        if( LoadScriptsCache( cache_key, pragmas, bytecode, lnt_data ) )
+        {
+            CallPragmas( pragmas );
+            SetGlobalPropertiesFromConfig();
+            pragmas_called = true;
+            if( RestoreRootModule( bytecode, lnt_data ) )
+                cache_loaded = true;
+            else
+                WriteLog( "Load scripts from bytecode cache fail, build from sources.\n" );
+        }
+    }
+
     // Build
+    // Cached pragmas produced by same sources, so after their calling sources built without pragmas
     string result_code;
-    if( !LoadRootModule( scripts, result_code ) )
+    if( !cache_loaded )
     {
-        WriteLog( "Load scripts from files fail.\n" );
-        return false;
+        if( !LoadRootModule( scripts, result_code, pragmas_called ) )
+        {
+            WriteLog( "Load scripts from files fail.\n" );
+            return false;
+        }
+
+        if( use_cache )
+            SaveScriptsCache( cache_key );
     }
 
     // Cache enums
     CacheEnumValues();
 
+    // External compilation results
+    // Interpreter still executes JIT entry instructions of not compiled functions, it makes them slower
+    if( edata->JitCompiler )
+    {
+        WriteLog( "JIT compiled functions {}, interpreted {}.\n", edata->JitCompiler->CompiledFunctions, edata->JitCompiler->InterpretedFunctions );
+        if( edata->JitCompiler->InterpretedFunctions )
+            WriteLog( "Warning! Functions not compiled by JIT run slower than without JIT compiler.\n" );
+    }
+
     // Add to profiler
     if( edata->Profiler )
     {
@@ -595,7 +948,7 @@ bool Script::ReloadScripts( const string& target )
     }
 
     // Done
-    WriteLog( "Reload scripts complete.\n" );
+    WriteLog( "Reload scripts complete{}, time {} ms.\n", cache_loaded ? " (bytecode cache)" : "", (uint) ( Timer::AccurateTick() - start_tick ) );
     return true;
 }
 
@@ -714,6 +1067,7 @@ asIScriptEngine* Script::CreateEngine( ScriptPragmaCallback* pragma_callback, co
     #endif
     edata->Invoker = new ScriptInvoker();
     edata->Profiler = nullptr;
+    edata->JitCompiler = nullptr;
     engine->SetUserData( edata );
     return engine;
 }
@@ -722,13 +1076,17 @@ void Script::FinishEngine( asIScriptEngine*& engine )
 {
     if( engine )
     {
-        EngineData* edata = (EngineData*) engine->SetUserData( nullptr );
+        EngineData*       edata = (EngineData*) engine->SetUserData( nullptr );
+        JitCompilerProxy* jit = edata->JitCompiler;
         delete edata->PragmaCB;
         for( auto it = edata->LoadedDlls.begin(), end = edata->LoadedDlls.end(); it != end; ++it )
             DLL_Free( it->second.second );
         delete edata;
         engine->ShutDownAndRelease();
         engine = nullptr;
+
+        // Engine releases compiled functions on shutdown
+        delete jit;
     }
 }
 
@@ -968,6 +1326,12 @@ void Script::RemoveEventsEntity( Entity* entity )
     edata->PragmaCB->RemoveEventsEntity( entity );
 }
 
+string Script::GetEventsStatistics()
+{
+    EngineData* edata = (EngineData*) Engine->GetUserData();
+    return edata->PragmaCB->GetEventsStatistics();
+}
+
 void Script::HandleRpc( void* context )
 {
     EngineData* edata = (EngineData*) Engine->GetUserData();
@@ -1023,14 +1387,22 @@ void Script::SetRunTimeout( uint abort_timeout, uint message_timeout )
 void Script::Define( const string& define )
 {
     Preprocessor::Define( define );
+    ActiveDefines.push_back( define );
 }
 
 void Script::Undef( const string& define )
 {
     if( !define.empty() )
+    {
         Preprocessor::Undef( define );
+        for( auto it = ActiveDefines.begin(); it != ActiveDefines.end();)
+            it = ( _str( *it ).substringUntil( ' ' ).str() == define ? ActiveDefines.erase( it ) : ++it );
+    }
     else
+    {
         Preprocessor::UndefAll();
+        ActiveDefines.clear();
+    }
 }
 
 void Script::CallPragmas( const Pragmas& pragmas )
@@ -1045,13 +1417,13 @@ void Script::CallPragmas( const Pragmas& pragmas )
         Preprocessor::CallPragma( pragmas[ i ] );
 }
 
-bool Script::LoadRootModule( const ScriptEntryVec& scripts, string& result_code )
+bool Script::LoadRootModule( const ScriptEntryVec& scripts, string& result_code, bool skip_pragmas /* = false */ )
 {
     RUNTIME_ASSERT( Engine->GetModuleCount() == 0 );
 
     // Set current pragmas
     EngineData* edata = (EngineData*) Engine->GetUserData();
-    Preprocessor::SetPragmaCallback( edata->PragmaCB );
+    Preprocessor::SetPragmaCallback( skip_pragmas ? nullptr : edata->PragmaCB );
 
     // File loader
     class MemoryFileLoader: public Preprocessor::FileLoader
@@ -1116,6 +1488,8 @@ public:
     MemoryFileLoader              loader( root, scripts );
     Preprocessor::StringOutStream result, errors;
     int                           errors_count = Preprocessor::Preprocess( "Root", result, &errors, &loader );
+    if( skip_pragmas )
+        Preprocessor::SetPragmaCallback( edata->PragmaCB );
 
     if( errors.String != "" )
     {
@@ -1131,51 +1505,7 @@ public:
     }
 
     // Set global properties from command line
-    for( auto& kv : config )
-    {
-        // Skip defines
-        if( kv.first.length() > 2 && kv.first[ 0 ] == '-' && kv.first[ 1 ] == '-' )
-            continue;
-
-        // Find property, with prefix and without
-        int index = Engine->GetGlobalPropertyIndexByName( ( "__" + kv.first ).c_str() );
-        if( index < 0 )
-        {
-            index = Engine->GetGlobalPropertyIndexByName( kv.first.c_str() );
-            if( index < 0 )
-                continue;
-        }
-
-        int   type_id;
-        void* ptr;
-        int   r = Engine->GetGlobalPropertyByIndex( index, nullptr, nullptr, &type_id, nullptr, nullptr, &ptr, nullptr );
-        RUNTIME_ASSERT( r >= 0 );
-
-        // Try set value
-        asITypeInfo* obj_type = ( type_id & asTYPEID_MASK_OBJECT ? Engine->GetTypeInfoById( type_id ) : nullptr );
-        bool         is_hashes[] = { false, false, false, false };
-        uchar        pod_buf[ 8 ];
-        bool         is_error = false;
-        void*        value = ReadValue( kv.second.c_str(), type_id, obj_type, is_hashes, 0, pod_buf, is_error );
-        if( !is_error )
-        {
-            if( !obj_type )
-            {
-                memcpy( ptr, value, Engine->GetSizeOfPrimitiveType( type_id ) );
-            }
-            else if( type_id & asTYPEID_OBJHANDLE )
-            {
-                if( *(void**) ptr )
-                    Engine->ReleaseScriptObject( *(void**) ptr, obj_type );
-                *(void**) ptr = value;
-            }
-            else
-            {
-                Engine->AssignScriptObject( ptr, value, obj_type );
-                Engine->ReleaseScriptObject( value, obj_type );
-            }
-        }
-    }
+    SetGlobalPropertiesFromConfig();
 
     // Add new
     asIScriptModule* module = Engine->GetModule( "Root", asGM_ALWAYS_CREATE );
@@ -35,6 +35,8 @@ typedef void ( *EndExecutionCallback )();
 typedef vector< asIScriptContext* >             ContextVec;
 typedef std::function< void ( const string& ) > ExceptionCallback;
 
+class JitCompilerProxy;
+
 struct EngineData
 {
     ScriptPragmaCallback*                PragmaCB;
@@ -43,6 +45,7 @@ struct EngineData
     map< string, pair< string, void* > > LoadedDlls;
     ScriptInvoker*                       Invoker;
     ScriptProfiler*                      Profiler;
+    JitCompilerProxy*                    JitCompiler;
     StrIntMap                            CachedEnums;
     map< string, IntStrMap >             CachedEnumNames;
 };
@@ -66,6 +69,10 @@ public:
     static void* LoadDynamicLibrary( const string& dll_name );
     static void  SetLoadLibraryCompiler( bool enabled );
 
+    // Extension point for external JIT compiler, library exports 'asIJITCompiler* CreateJitCompiler( asIScriptEngine* engine )'
+    // Must be called before scripts loading, functions that compiler rejects stay in interpreter
+    static bool InitJitCompiler( const string& dll_name );
+
     static void UnloadScripts();
     static bool ReloadScripts( const string& target );
     static bool PostInitScriptSystem();
@@ -106,9 +113,10 @@ public:
     static bool RestoreCustomEntity( const string& type_name, uint id, const DataBase::Document& doc );
     #endif
 
-    static void* FindInternalEvent( const string& event_name );
-    static bool  RaiseInternalEvent( void* event_ptr, ... );
-    static void  RemoveEventsEntity( Entity* entity );
+    static void*  FindInternalEvent( const string& event_name );
+    static bool   RaiseInternalEvent( void* event_ptr, ... );
+    static void   RemoveEventsEntity( Entity* entity );
+    static string GetEventsStatistics();
 
     static void HandleRpc( void* context );
 
@@ -120,7 +128,7 @@ public:
     static void Define( const string& define );
     static void Undef( const string& define );
     static void CallPragmas( const Pragmas& pragmas );
-    static bool LoadRootModule( const ScriptEntryVec& scripts, string& result_code );
+    static bool LoadRootModule( const ScriptEntryVec& scripts, string& result_code, bool skip_pragmas = false );
     static bool RestoreRootModule( const UCharVec& bytecode, const UCharVec& lnt_data );
 
     static uint               BindByFuncName( const string& func_name, const string& decl, bool is_temp, bool disable_log = false );
@@ -71,7 +71,7 @@ uint ScriptInvoker::AddDeferredCall( uint delay, bool saved, asIScriptFunction*
         RUNTIME_ASSERT( call.FireFullSecond != 0 );
         call.Id = Globals->GetLastDeferredCallId() + 1;
         Globals->SetLastDeferredCallId( call.Id );
-        deferredCalls.push_back( call );
+        AddDeferredCallToQueue( call );
 
         #if defined ( FONLINE_SERVER ) || defined ( FONLINE_EDITOR )
         if( call.Saved )
@@ -102,78 +102,72 @@ uint ScriptInvoker::AddDeferredCall( uint delay, bool saved, asIScriptFunction*
     return call.Id;
 }
 
+void ScriptInvoker::AddDeferredCallToQueue( const DeferredCall& call )
+{
+    RUNTIME_ASSERT( call.FireFullSecond != 0 );
+
+    auto it = deferredCalls.insert( std::make_pair( call.Id, call ) );
+    RUNTIME_ASSERT( it.second );
+    deferredCallsQueue.insert( std::make_pair( call.FireFullSecond, call.Id ) );
+}
+
 bool ScriptInvoker::IsDeferredCallPending( uint id )
 {
-    for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
-        if( it->Id == id )
-            return true;
-    return false;
+    return deferredCalls.count( id ) > 0;
 }
 
 bool ScriptInvoker::CancelDeferredCall( uint id )
 {
-    for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
-    {
-        if( it->Id == id )
-        {
-            #if defined ( FONLINE_SERVER ) || defined ( FONLINE_EDITOR )
-            if( it->Saved )
-                DbStorage->Delete( "DeferredCalls", id );
-            #endif
-
-            deferredCalls.erase( it );
-            return true;
-        }
-    }
-    return false;
+    auto it = deferredCalls.find( id );
+    if( it == deferredCalls.end() )
+        return false;
+
+    #if defined ( FONLINE_SERVER ) || defined ( FONLINE_EDITOR )
+    if( it->second.Saved )
+        DbStorage->Delete( "DeferredCalls", id );
+    #endif
+
+    deferredCallsQueue.erase( std::make_pair( it->second.FireFullSecond, id ) );
+    deferredCalls.erase( it );
+    return true;
 }
 
 bool ScriptInvoker::GetDeferredCallData( uint id, DeferredCall& data )
 {
-    for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
-    {
-        DeferredCall& call = *it;
-        if( call.Id == id )
-        {
-            data = call;
-            return true;
-        }
-    }
-    return false;
+    auto it = deferredCalls.find( id );
+    if( it == deferredCalls.end() )
+        return false;
+
+    data = it->second;
+    return true;
 }
 
 void ScriptInvoker::GetDeferredCallsList( IntVec& ids )
 {
     ids.reserve( deferredCalls.size() );
     for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
-        ids.push_back( it->Id );
+        ids.push_back( it->first );
 }
 
 void ScriptInvoker::Process()
 {
-    bool done = false;
-    while( !done )
+    // Queue sorted by fire time, so stop on first not expired call
+    while( !deferredCallsQueue.empty() && GameOpt.FullSecond >= deferredCallsQueue.begin()->first )
     {
-        done = true;
+        uint id = deferredCallsQueue.begin()->second;
+        deferredCallsQueue.erase( deferredCallsQueue.begin() );
 
-        for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
-        {
-            RUNTIME_ASSERT( it->FireFullSecond != 0 );
-            if( GameOpt.FullSecond >= it->FireFullSecond )
-            {
-                DeferredCall call = *it;
-                it = deferredCalls.erase( it );
+        auto it = deferredCalls.find( id );
+        RUNTIME_ASSERT( it != deferredCalls.end() );
+        DeferredCall call = std::move( it->second );
+        deferredCalls.erase( it );
 
-                #if defined ( FONLINE_SERVER ) || defined ( FONLINE_EDITOR )
-                if( call.Saved )
-                    DbStorage->Delete( "DeferredCalls", call.Id );
-                #endif
+        #if defined ( FONLINE_SERVER ) || defined ( FONLINE_EDITOR )
+        if( call.Saved )
+            DbStorage->Delete( "DeferredCalls", call.Id );
+        #endif
 
-                RunDeferredCall( call );
-                done = false;
-                break;
-            }
-        }
+        RunDeferredCall( call );
     }
 }
 
@@ -210,7 +204,7 @@ string ScriptInvoker::GetStatistics()
     result += "Id         Delay      Saved    Function                                                              Values\n";
     for( auto it = deferredCalls.begin(); it != deferredCalls.end(); ++it )
     {
-        DeferredCall& call = *it;
+        DeferredCall& call = it->second;
         string        func_name = Script::GetBindFuncName( call.BindId );
         uint          delay = call.FireFullSecond > GameOpt.FullSecond ? ( call.FireFullSecond - GameOpt.FullSecond ) * time_mul / 1000 : 0;
 
@@ -249,7 +243,7 @@ bool ScriptInvoker::LoadDeferredCalls()
         DataBase::Document call_doc = DbStorage->Get( "DeferredCalls", call_id );
 
         DeferredCall       call;
-        call.Id = call_doc[ "Id" ].get< int >();
+        call.Id = call_id;
         call.FireFullSecond = (uint) call_doc[ "FireFullSecond" ].get< int64 >();
         RUNTIME_ASSERT( call.FireFullSecond != 0 );
 
@@ -315,7 +309,7 @@ bool ScriptInvoker::LoadDeferredCalls()
         }
 
         call.Saved = true;
-        deferredCalls.push_back( call );
+        AddDeferredCallToQueue( call );
     }
 
     WriteLog( "Load deferred calls complete, count {}.\n", (uint) deferredCalls.size() );
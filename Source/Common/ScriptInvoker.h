@@ -18,20 +18,23 @@ struct DeferredCall
     IntVec Values;
     bool   Saved;
 };
-typedef list< DeferredCall > DeferredCallList;
+typedef map< uint, DeferredCall >       DeferredCallMap;
+typedef set< std::pair< uint, uint > > DeferredCallQueue; // Fire full second and id
 
 class ScriptInvoker
 {
     friend class Script;
 
 private:
-    DeferredCallList deferredCalls;
+    DeferredCallMap   deferredCalls;
+    DeferredCallQueue deferredCallsQueue;
 
     ScriptInvoker();
     uint   AddDeferredCall( uint delay, bool saved, asIScriptFunction* func, int* value, CScriptArray* values );
     bool   IsDeferredCallPending( uint id );
     bool   CancelDeferredCall( uint id );
     bool   GetDeferredCallData( uint id, DeferredCall& data );
+    void   AddDeferredCallToQueue( const DeferredCall& call );
     void   GetDeferredCallsList( IntVec& ids );
     void   Process();
     void   RunDeferredCall( DeferredCall& call );
@@ -848,30 +848,43 @@ class EventPragma
     class ScriptEvent
     {
 public:
-        typedef vector< asIScriptFunction* >           FuncVec;
-        typedef multimap< uint64, asIScriptFunction* > FuncMulMap;
-        typedef multimap< Entity*, FuncMulMap* >       EntityFuncMulMap;
+        static const uint MaxArgs = 16;
+        static const uint InlineCallbacks = 16;
+
+        struct ArgInfo;
+        typedef vector< asIScriptFunction* >            FuncVec;
+        typedef unordered_map< uint64, FuncVec >        FuncHashMap;
+        typedef unordered_multimap< Entity*, ArgInfo* > EntityArgMulMap;
 
         struct ArgInfo
         {
-            bool       IsObjectEntity;
-            bool       IsObject;
-            bool       IsPodRef;
-            uint       PodSize;
-            FuncMulMap Callbacks;
+            ScriptEvent* Event;
+            bool         IsObjectEntity;
+            bool         IsObject;
+            bool         IsPodRef;
+            uint         PodSize;
+            FuncHashMap  Callbacks; // Subscribers by argument value, in subscription order
         };
         typedef vector< ArgInfo > ArgInfoVec;
 
-        string            Name;
-        mutable int       RefCount;
-        bool              Deferred;
-        FuncVec           Callbacks;
-        ArgInfoVec        ArgInfos;
-        EntityFuncMulMap* EntityCallbacks;
+        string           Name;
+        mutable int      RefCount;
+        bool             Deferred;
+        FuncVec          Callbacks;
+        ArgInfoVec       ArgInfos;
+        EntityArgMulMap* EntityCallbacks;
+
+        // Statistics
+        uint             SubscribersCount;
+        int64            RaisesCount;
+        int64            CallsCount;
 
         ScriptEvent()
         {
             RefCount = 1;
+            SubscribersCount = 0;
+            RaisesCount = 0;
+            CallsCount = 0;
         }
 
         ~ScriptEvent()
@@ -897,6 +910,7 @@ public:
             Unsubscribe( callback );
 
             Callbacks.push_back( callback );
+            SubscribersCount++;
         }
 
         void Unsubscribe( asIScriptFunction* callback )
@@ -904,44 +918,56 @@ public:
             if( Callbacks.empty() )
                 return;
 
-            auto it = std::find( Callbacks.begin(), Callbacks.end(), callback );
-            if( it == Callbacks.end() && callback->GetFuncType() == asFUNC_DELEGATE )
-            {
-                it = std::find_if( Callbacks.begin(), Callbacks.end(), [ &callback ] ( asIScriptFunction * cb )
-                                   {
-                                       return cb->GetFuncType() == asFUNC_DELEGATE && cb->GetDelegateFunction() == callback->GetDelegateFunction();
-                                   } );
-            }
-
+            auto it = FindCallback( Callbacks, callback );
             if( it != Callbacks.end() )
             {
                 ( *it )->Release();
                 Callbacks.erase( it );
+                SubscribersCount--;
             }
         }
 
-        static void SubscribeTo( asIScriptGeneric* gen )
+        static FuncVec::iterator FindCallback( FuncVec& callbacks, asIScriptFunction* callback )
         {
-            UnsubscribeFrom( gen );
-
-            int          arg_index = *(int*) gen->GetAuxiliary();
-            ScriptEvent* event = (ScriptEvent*) gen->GetObject();
-            ArgInfo&     arg_info = event->ArgInfos[ arg_index ];
+            auto it = std::find( callbacks.begin(), callbacks.end(), callback );
+            if( it == callbacks.end() && callback->GetFuncType() == asFUNC_DELEGATE )
+            {
+                it = std::find_if( callbacks.begin(), callbacks.end(), [ &callback ] ( asIScriptFunction * cb )
+                                   {
+                                       return cb->GetFuncType() == asFUNC_DELEGATE && cb->GetDelegateFunction() == callback->GetDelegateFunction();
+                                   } );
+            }
+            return it;
+        }
 
-            uint64       value = 0;
+        static uint64 GetSubscribeValue( asIScriptGeneric* gen, const ArgInfo& arg_info )
+        {
+            uint64 value = 0;
             if( arg_info.IsObject )
                 value = (uint64) gen->GetArgObject( 0 );
             else if( arg_info.IsPodRef )
                 memcpy( &value, gen->GetArgAddress( 0 ), arg_info.PodSize );
             else
                 memcpy( &value, gen->GetAddressOfArg( 0 ), arg_info.PodSize );
+            return value;
+        }
+
+        static void SubscribeTo( asIScriptGeneric* gen )
+        {
+            UnsubscribeFrom( gen );
 
+            int                arg_index = *(int*) gen->GetAuxiliary();
+            ScriptEvent*       event = (ScriptEvent*) gen->GetObject();
+            ArgInfo&           arg_info = event->ArgInfos[ arg_index ];
+            uint64             value = GetSubscribeValue( gen, arg_info );
             asIScriptFunction* callback = (asIScriptFunction*) gen->GetArgObject( 1 );
+
             callback->AddRef();
-            arg_info.Callbacks.insert( std::make_pair( value, callback ) );
+            arg_info.Callbacks[ value ].push_back( callback );
+            event->SubscribersCount++;
 
             if( arg_info.IsObjectEntity )
-                event->EntityCallbacks->insert( std::make_pair( (Entity*) gen->GetArgObject( 0 ), &arg_info.Callbacks ) );
+                event->EntityCallbacks->insert( std::make_pair( (Entity*) gen->GetArgObject( 0 ), &arg_info ) );
         }
 
         static void UnsubscribeFrom( asIScriptGeneric* gen )
@@ -949,42 +975,34 @@ public:
             int                arg_index = *(int*) gen->GetAuxiliary();
             ScriptEvent*       event = (ScriptEvent*) gen->GetObject();
             ArgInfo&           arg_info = event->ArgInfos[ arg_index ];
+            uint64             value = GetSubscribeValue( gen, arg_info );
             asIScriptFunction* callback = (asIScriptFunction*) gen->GetArgObject( 1 );
 
-            uint64             value = 0;
-            if( arg_info.IsObject )
-                value = (uint64) gen->GetArgObject( 0 );
-            else if( arg_info.IsPodRef )
-                memcpy( &value, gen->GetArgAddress( 0 ), arg_info.PodSize );
-            else
-                memcpy( &value, gen->GetAddressOfArg( 0 ), arg_info.PodSize );
-
             // Erase from arg callbacks
-            auto range = arg_info.Callbacks.equal_range( value );
-            auto it = std::find_if( range.first, range.second, [ &callback ] ( FuncMulMap::value_type & kv ) { return kv.second == callback; } );
-            if( it == range.second && callback->GetFuncType() == asFUNC_DELEGATE )
-            {
-                it = std::find_if( range.first, range.second, [ &callback ] ( FuncMulMap::value_type & kv )
-                                   {
-                                       return kv.second->GetFuncType() == asFUNC_DELEGATE && kv.second->GetDelegateFunction() == callback->GetDelegateFunction();
-                                   } );
-            }
+            auto it_value = arg_info.Callbacks.find( value );
+            if( it_value == arg_info.Callbacks.end() )
+                return;
 
-            if( it != range.second )
-            {
-                // Erase from entity callbacks
-                if( arg_info.IsObjectEntity )
-                {
-                    auto range_ = event->EntityCallbacks->equal_range( (Entity*) gen->GetArgObject( 0 ) );
-                    auto cb_ptr = &arg_info.Callbacks;
-                    auto it_ = std::find_if( range_.first, range_.second, [ &cb_ptr ] ( EntityFuncMulMap::value_type & kv ) { return kv.second == cb_ptr; } );
-                    RUNTIME_ASSERT( it_ != range_.second );
-                    event->EntityCallbacks->erase( it_ );
-                }
+            FuncVec& callbacks = it_value->second;
+            auto     it = FindCallback( callbacks, callback );
+            if( it == callbacks.end() )
+                return;
 
-                it->second->Release();
-                arg_info.Callbacks.erase( it );
+            // Erase from entity callbacks
+            if( arg_info.IsObjectEntity )
+            {
+                auto range = event->EntityCallbacks->equal_range( (Entity*) gen->GetArgObject( 0 ) );
+                auto arg_info_ptr = &arg_info;
+                auto it_ = std::find_if( range.first, range.second, [ &arg_info_ptr ] ( EntityArgMulMap::value_type & kv ) { return kv.second == arg_info_ptr; } );
+                RUNTIME_ASSERT( it_ != range.second );
+                event->EntityCallbacks->erase( it_ );
             }
+
+            ( *it )->Release();
+            callbacks.erase( it );
+            if( callbacks.empty() )
+                arg_info.Callbacks.erase( it_value );
+            event->SubscribersCount--;
         }
 
         void UnsubscribeAll()
@@ -997,72 +1015,88 @@ public:
             // Args callbacks
             for( auto& arg_info : ArgInfos )
             {
-                for( auto& arg_callback : arg_info.Callbacks )
-                    arg_callback.second->Release();
+                for( auto& kv : arg_info.Callbacks )
+                    for( asIScriptFunction* callback : kv.second )
+                        callback->Release();
                 arg_info.Callbacks.clear();
             }
 
             // Entity callbacks
             for( auto it = EntityCallbacks->begin(); it != EntityCallbacks->end();)
             {
-                bool erased = false;
-                for( auto it_ = ArgInfos.begin(); it_ != ArgInfos.end(); ++it_ )
-                {
-                    if( it->second == &it_->Callbacks )
-                    {
-                        it = EntityCallbacks->erase( it );
-                        erased = true;
-                        break;
-                    }
-                }
-                if( !erased )
+                if( it->second->Event == this )
+                    it = EntityCallbacks->erase( it );
+                else
                     ++it;
             }
+
+            SubscribersCount = 0;
         }
 
         static void Raise( asIScriptGeneric* gen )
         {
             ScriptEvent* event = (ScriptEvent*) gen->GetObject();
-            *(bool*) gen->GetAddressOfReturnLocation() = event->RaiseImpl( gen, nullptr );
+            event->RaisesCount++;
+            *(bool*) gen->GetAddressOfReturnLocation() = ( event->SubscribersCount ? event->RaiseImpl( gen, nullptr ) : true );
         }
 
         static bool RaiseInternal( void* event_ptr, va_list args )
         {
             ScriptEvent* event = (ScriptEvent*) event_ptr;
+            event->RaisesCount++;
 
-            UInt64Vec    va_args;
+            // Nobody listens
+            if( !event->SubscribersCount )
+                return true;
+
+            uint64 va_args[ MaxArgs ];
             for( size_t i = 0; i < event->ArgInfos.size(); i++ )
             {
                 const ArgInfo& arg_info = event->ArgInfos[ i ];
                 if( arg_info.IsObject )
-                    va_args.push_back( (uint64) va_arg( args, void* ) );
+                    va_args[ i ] = (uint64) va_arg( args, void* );
                 else if( arg_info.IsPodRef )
-                    va_args.push_back( (uint64) va_arg( args, void* ) );
+                    va_args[ i ] = (uint64) va_arg( args, void* );
                 else if( arg_info.PodSize == 1 )
-                    va_args.push_back( (uint64) va_arg( args, int ) );
+                    va_args[ i ] = (uint64) va_arg( args, int );
                 else if( arg_info.PodSize == 2 )
-                    va_args.push_back( (uint64) va_arg( args, int ) );
+                    va_args[ i ] = (uint64) va_arg( args, int );
                 else if( arg_info.PodSize == 4 )
-                    va_args.push_back( (uint64) va_arg( args, int ) );
+                    va_args[ i ] = (uint64) va_arg( args, int );
                 else if( arg_info.PodSize == 8 )
-                    va_args.push_back( (uint64) va_arg( args, int64 ) );
+                    va_args[ i ] = (uint64) va_arg( args, int64 );
                 else
                     RUNTIME_ASSERT( !"Unreachable place" );
             }
 
-            return event->RaiseImpl( nullptr, &va_args );
+            return event->RaiseImpl( nullptr, va_args );
         }
 
-        bool RaiseImpl( asIScriptGeneric* gen_args, UInt64Vec* va_args )
+        bool RaiseImpl( asIScriptGeneric* gen_args, uint64* va_args )
         {
-            #define GET_ARG_ADDR    ( gen_args ? gen_args->GetAddressOfArg( (asUINT) i ) : &va_args->at( i ) )
+            #define GET_ARG_ADDR    ( gen_args ? gen_args->GetAddressOfArg( (asUINT) i ) : &va_args[ i ] )
             #define GET_ARG( type )    ( *(type*) GET_ARG_ADDR )
 
-            FuncVec callbacks_to_call;
+            // Snapshot of callbacks, subscriptions may change during calls
+            // First callbacks are stored inline, without allocation
+            asIScriptFunction* inline_callbacks[ InlineCallbacks ];
+            FuncVec            heap_callbacks;
+            uint               callbacks_count = 0;
+            auto               add_callbacks = [ & ] ( const FuncVec &callbacks )
+            {
+                for( asIScriptFunction* callback : callbacks )
+                {
+                    if( callbacks_count < InlineCallbacks )
+                        inline_callbacks[ callbacks_count ] = callback;
+                    else
+                        heap_callbacks.push_back( callback );
+                    callbacks_count++;
+                }
+            };
 
             // Global callbacks
             if( !Callbacks.empty() )
-                callbacks_to_call = Callbacks;
+                add_callbacks( Callbacks );
 
             // Arg callbacks
             for( size_t i = 0; i < ArgInfos.size(); i++ )
@@ -1087,15 +1121,15 @@ public:
                 else
                     RUNTIME_ASSERT( !"Unreachable place" );
 
-                auto range = arg_info.Callbacks.equal_range( value );
-                for( auto it = range.first; it != range.second; ++it )
-                    callbacks_to_call.push_back( it->second );
+                auto it = arg_info.Callbacks.find( value );
+                if( it != arg_info.Callbacks.end() )
+                    add_callbacks( it->second );
             }
 
             // Invoke callbacks
-            for( int j = (int) callbacks_to_call.size() - 1; j >= 0; j-- )
+            for( int j = (int) callbacks_count - 1; j >= 0; j-- )
             {
-                asIScriptFunction* callback = callbacks_to_call[ j ];
+                asIScriptFunction* callback = ( j < (int) InlineCallbacks ? inline_callbacks[ j ] : heap_callbacks[ j - InlineCallbacks ] );
 
                 // Check entities
                 for( size_t i = 0; i < ArgInfos.size(); i++ )
@@ -1109,6 +1143,8 @@ public:
                     }
                 }
 
+                CallsCount++;
+
                 uint bind_id = Script::BindByFunc( callback, true );
                 Script::PrepareContext( bind_id, "Event" );
 
@@ -1151,13 +1187,15 @@ public:
                     Script::RunPreparedSuspend();
                 }
             }
+
             #undef GET_ARG
+            #undef GET_ARG_ADDR
             return true;
         }
     };
 
-    list< ScriptEvent* >          events;
-    ScriptEvent::EntityFuncMulMap entityCallbacks;
+    list< ScriptEvent* >         events;
+    ScriptEvent::EntityArgMulMap entityCallbacks;
 
 public:
     EventPragma()
@@ -1218,6 +1256,13 @@ public:
         event->EntityCallbacks = &entityCallbacks;
 
         asIScriptFunction* func_def = engine->GetFunctionById( func_def_id );
+        if( func_def->GetParamCount() > ScriptEvent::MaxArgs )
+        {
+            WriteLog( "Event '{}' has more than {} arguments.\n", event_name, ScriptEvent::MaxArgs );
+            event->Release();
+            return false;
+        }
+
         event->ArgInfos.resize( func_def->GetParamCount() );
         for( asUINT i = 0; i < func_def->GetParamCount(); i++ )
         {
@@ -1227,6 +1272,7 @@ public:
             func_def->GetParam( i, &type_id, &flags, &name );
 
             ScriptEvent::ArgInfo& arg_info = event->ArgInfos[ i ];
+            arg_info.Event = event;
             arg_info.IsObject = ( type_id & asTYPEID_MASK_OBJECT ) != 0;
             arg_info.IsPodRef = ( type_id >= asTYPEID_BOOL && type_id <= asTYPEID_DOUBLE && flags & asTM_INOUTREF );
             arg_info.PodSize = engine->GetSizeOfPrimitiveType( type_id );
@@ -1297,15 +1343,30 @@ public:
         auto range = entityCallbacks.equal_range( entity );
         if( range.first != range.second )
         {
+            // One entry per subscription, all of them dropped with first entry of each argument
             for( auto it = range.first; it != range.second; ++it )
             {
-                auto range_ = it->second->equal_range( (uint64) entity );
-                RUNTIME_ASSERT( range_.first != range_.second );
-                it->second->erase( range_.first );
+                ScriptEvent::ArgInfo* arg_info = it->second;
+                auto                  it_ = arg_info->Callbacks.find( (uint64) entity );
+                if( it_ != arg_info->Callbacks.end() )
+                {
+                    for( asIScriptFunction* callback : it_->second )
+                        callback->Release();
+                    arg_info->Event->SubscribersCount -= (uint) it_->second.size();
+                    arg_info->Callbacks.erase( it_ );
+                }
             }
             entityCallbacks.erase( range.first, range.second );
         }
     }
+
+    string GetStatistics()
+    {
+        string result = "Event                                    Subscribers  Raises          Calls\n";
+        for( ScriptEvent* event : events )
+            result += _str( "{:<40} {:<12} {:<15} {}\n", event->Name, event->SubscribersCount, event->RaisesCount, event->CallsCount );
+        return result;
+    }
 };
 
 // #pragma rpc
@@ -1749,6 +1810,11 @@ void ScriptPragmaCallback::RemoveEventsEntity( Entity* entity )
     eventPragma->RemoveEntity( entity );
 }
 
+string ScriptPragmaCallback::GetEventsStatistics()
+{
+    return eventPragma->GetStatistics();
+}
+
 void ScriptPragmaCallback::HandleRpc( void* context )
 {
     rpcPragma->HandleRpc( context );
@@ -0,0 +1,120 @@
+#ifndef __SPATIAL_GRID__
+#define __SPATIAL_GRID__
+
+#include "Common.h"
+#include "Exception.h"
+
+// Hex map spatial index, objects bucketed by square cells
+#define SPATIAL_CELL_SIZE    ( 16 )
+
+template< class T >
+class HexSpatialGrid
+{
+private:
+    // Order is assigned once on Add and kept across cell moves, cells are sorted by it,
+    // so query results follow the same order as the owner's plain lists
+    struct CellEntry
+    {
+        T*     Obj;
+        uint64 Order;
+    };
+
+    vector< vector< CellEntry > > cells;
+    uint                          cellsWidth = 0;
+    uint                          cellsHeight = 0;
+    uint64                        orderCounter = 0;
+
+    vector< CellEntry >& GetCell( ushort hx, ushort hy )
+    {
+        return cells[ ( hy / SPATIAL_CELL_SIZE ) * cellsWidth + hx / SPATIAL_CELL_SIZE ];
+    }
+
+    CellEntry Extract( T* obj, ushort hx, ushort hy )
+    {
+        vector< CellEntry >& cell = GetCell( hx, hy );
+        auto                 it = std::find_if( cell.begin(), cell.end(), [ obj ] ( const CellEntry& entry ) { return entry.Obj == obj; } );
+        RUNTIME_ASSERT( it != cell.end() );
+        CellEntry            entry = *it;
+        cell.erase( it );
+        return entry;
+    }
+
+public:
+    void Init( ushort width, ushort height )
+    {
+        cellsWidth = ( width + SPATIAL_CELL_SIZE - 1 ) / SPATIAL_CELL_SIZE;
+        cellsHeight = ( height + SPATIAL_CELL_SIZE - 1 ) / SPATIAL_CELL_SIZE;
+        cells.clear();
+        cells.resize( cellsWidth * cellsHeight );
+    }
+
+    void Clear()
+    {
+        cells.clear();
+        cellsWidth = 0;
+        cellsHeight = 0;
+        orderCounter = 0;
+    }
+
+    void Add( T* obj, ushort hx, ushort hy )
+    {
+        GetCell( hx, hy ).push_back( CellEntry { obj, orderCounter++ } );
+    }
+
+    void Remove( T* obj, ushort hx, ushort hy )
+    {
+        Extract( obj, hx, hy );
+    }
+
+    void Move( T* obj, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy )
+    {
+        if( from_hx / SPATIAL_CELL_SIZE != to_hx / SPATIAL_CELL_SIZE || from_hy / SPATIAL_CELL_SIZE != to_hy / SPATIAL_CELL_SIZE )
+        {
+            CellEntry            entry = Extract( obj, from_hx, from_hy );
+            vector< CellEntry >& cell = GetCell( to_hx, to_hy );
+            auto                 it = std::upper_bound( cell.begin(), cell.end(), entry, [] ( const CellEntry& l, const CellEntry& r ) { return l.Order < r.Order; } );
+            cell.insert( it, entry );
+        }
+    }
+
+    // Append objects from all cells overlapped by radius that pass filter, in insertion order
+    // Game distance never less than axis offsets, so cells box always covers radius
+    template< class Filter >
+    void Collect( ushort hx, ushort hy, uint radius, vector< T* >& objects, Filter filter )
+    {
+        if( cells.empty() )
+            return;
+
+        int                 cx = hx / SPATIAL_CELL_SIZE;
+        int                 cy = hy / SPATIAL_CELL_SIZE;
+        int                 cr = (int) ( ( MIN( radius, 0xFFFFu ) + SPATIAL_CELL_SIZE - 1 ) / SPATIAL_CELL_SIZE );
+        int                 x1 = MAX( cx - cr, 0 );
+        int                 y1 = MAX( cy - cr, 0 );
+        int                 x2 = MIN( cx + cr, (int) cellsWidth - 1 );
+        int                 y2 = MIN( cy + cr, (int) cellsHeight - 1 );
+        vector< CellEntry > entries;
+        uint                filled_cells = 0;
+        for( int y = y1; y <= y2; y++ )
+        {
+            for( int x = x1; x <= x2; x++ )
+            {
+                size_t prev_size = entries.size();
+                for( const CellEntry& entry : cells[ y * cellsWidth + x ] )
+                    if( filter( entry.Obj ) )
+                        entries.push_back( entry );
+                if( entries.size() != prev_size )
+                    filled_cells++;
+            }
+        }
+
+        // Single cell already ordered
+        if( filled_cells > 1 )
+            std::sort( entries.begin(), entries.end(), [] ( const CellEntry& l, const CellEntry& r ) { return l.Order < r.Order; } );
+
+        objects.reserve( objects.size() + entries.size() );
+        for( const CellEntry& entry : entries )
+            objects.push_back( entry.Obj );
+    }
+};
+
+#endif // __SPATIAL_GRID__
@@ -6,7 +6,9 @@
 #include "MapManager.h"
 #include "ItemManager.h"
 #include "CritterManager.h"
+#include "EntityManager.h"
 #include "ProtoManager.h"
+#include "FileSystem.h"
 #include "StringUtils.h"
 
 /************************************************************************/
@@ -83,6 +85,8 @@ CLASS_PROPERTY_IMPL( Critter, ShowCritterDist2 );
 CLASS_PROPERTY_IMPL( Critter, ShowCritterDist3 );
 CLASS_PROPERTY_IMPL( Critter, ScriptId );
 
+CritterVec Critter::timeEventsChangedCritters;
+
 Critter::Critter( uint id, EntityType type, ProtoCritter* proto ): Entity( id, type, PropertiesRegistrator, proto )
 {
     CritterIsNpc = false;
@@ -98,6 +102,10 @@ Critter::Critter( uint id, EntityType type, ProtoCritter* proto ): Entity( id, t
     ViewMapLook = 0;
     ViewMapHx = ViewMapHy = 0;
     ViewMapDir = 0;
+    VisProcessMapId = 0;
+    VisProcessHexX = VisProcessHexY = 0;
+    timeEventsLoaded = false;
+    timeEventsChanged = false;
     DisableSend = 0;
     CanBeRemoved = false;
     Name = "";
@@ -236,7 +244,32 @@ void Critter::ProcessVisibleCritters()
     // Sneak self
     int  sneak_base_self = GetSneakCoefficient();
 
-    for( Critter* cr : map->GetCritters() )
+    // Critters to check
+    CritterVec critters;
+    bool       check_neighbors = ( FLAG( GameOpt.LookChecks, LOOK_CHECK_NEIGHBORS ) && !FLAG( GameOpt.LookChecks, LOOK_CHECK_SCRIPT ) );
+
+    if( check_neighbors )
+    {
+        // Virtual distances change without set callback, so take bound from current getter values
+        if( ( PropertyLookDistance->GetAccess() | PropertyShowCritterDist1->GetAccess() |
+              PropertyShowCritterDist2->GetAccess() | PropertyShowCritterDist3->GetAccess() ) & Property::VirtualMask )
+            map->RefreshCrittersLookRadius();
+        else
+            map->UpdateCrittersLookRadius( MAX( MAX( (uint) MAX( look_base_self, 0 ), GameOpt.LookMinimum ), MAX( show_cr_dist1, MAX( show_cr_dist2, show_cr_dist3 ) ) ) );
+        GetVisibleCandidates( map, critters );
+        if( FLAG( GameOpt.LookChecks, LOOK_CHECK_NEIGHBORS_VERIFY ) )
+            VerifyVisibleCandidates( map, critters );
+    }
+    else
+    {
+        critters = map->GetCritters();
+    }
+
+    VisProcessMapId = map->GetId();
+    VisProcessHexX = GetHexX();
+    VisProcessHexY = GetHexY();
+
+    for( Critter* cr : critters )
     {
         if( cr == this || cr->IsDestroyed )
             continue;
@@ -373,6 +406,9 @@ void Critter::ProcessVisibleCritters()
         int look_self = look_base_self;
         int look_opp = cr->GetLookDistance();
 
+        if( check_neighbors )
+            map->UpdateCrittersLookRadius( MAX( (uint) MAX( look_opp, 0 ), MAX( cr->GetShowCritterDist1(), MAX( cr->GetShowCritterDist2(), cr->GetShowCritterDist3() ) ) ) );
+
         // Dir modifier
         if( FLAG( GameOpt.LookChecks, LOOK_CHECK_DIR ) )
         {
@@ -576,6 +612,64 @@ void Critter::ProcessVisibleCritters()
     }
 }
 
+void Critter::GetVisibleCandidates( Map* map, CritterVec& critters )
+{
+    // Pair visibility can change only within look radius around current or previous checked position
+    uint radius = map->GetCrittersLookRadius();
+    map->GetCrittersHex( GetHexX(), GetHexY(), radius, FIND_ALL, critters );
+    if( VisProcessMapId == map->GetId() && ( VisProcessHexX != GetHexX() || VisProcessHexY != GetHexY() ) )
+        map->GetCrittersHex( VisProcessHexX, VisProcessHexY, radius, FIND_ALL, critters );
+
+    // Already linked critters, to process hiding
+    critters.insert( critters.end(), VisCr.begin(), VisCr.end() );
+    critters.insert( critters.end(), VisCrSelf.begin(), VisCrSelf.end() );
+    UIntSet* vis_sets[] = { &VisCr1, &VisCr2, &VisCr3 };
+    for( UIntSet* vis_set : vis_sets )
+    {
+        for( uint crid : *vis_set )
+        {
+            Critter* cr = CrMngr.GetCritter( crid );
+            if( cr && cr->GetMapId() == map->GetId() )
+                critters.push_back( cr );
+        }
+    }
+
+    // Unique, in stable order
+    std::sort( critters.begin(), critters.end(), [] ( Critter * cr1, Critter * cr2 )
+               {
+                   return cr1->GetId() < cr2->GetId();
+               } );
+    critters.erase( std::unique( critters.begin(), critters.end() ), critters.end() );
+}
+
+void Critter::VerifyVisibleCandidates( Map* map, CritterVec& critters )
+{
+    // Full scan pass over skipped critter must change nothing:
+    // no links to it and distance beyond every look and show distance of both sides
+    uint look_self = MAX( MAX( (uint) MAX( (int) GetLookDistance(), 0 ), GameOpt.LookMinimum ),
+                          MAX( GetShowCritterDist1(), MAX( GetShowCritterDist2(), GetShowCritterDist3() ) ) );
+    for( Critter* cr : map->GetCrittersRaw() )
+    {
+        if( cr == this || cr->IsDestroyed || std::binary_search( critters.begin(), critters.end(), cr, [] ( Critter * cr1, Critter * cr2 )
+                                                                 {
+                                                                     return cr1->GetId() < cr2->GetId();
+                                                                 } ) )
+            continue;
+
+        uint look_opp = MAX( (uint) MAX( (int) cr->GetLookDistance(), 0 ),
+                             MAX( cr->GetShowCritterDist1(), MAX( cr->GetShowCritterDist2(), cr->GetShowCritterDist3() ) ) );
+        uint dist = DistGame( GetHexX(), GetHexY(), cr->GetHexX(), cr->GetHexY() );
+        bool linked = ( VisCrMap.count( cr->GetId() ) || VisCrSelfMap.count( cr->GetId() ) ||
+                        VisCr1.count( cr->GetId() ) || VisCr2.count( cr->GetId() ) || VisCr3.count( cr->GetId() ) ||
+                        cr->VisCr1.count( GetId() ) || cr->VisCr2.count( GetId() ) || cr->VisCr3.count( GetId() ) );
+        if( linked || dist <= MAX( look_self, look_opp ) )
+        {
+            WriteLog( "Neighbors look check skipped critter '{}' for '{}', distance {}, look {}/{}, linked {}, map look radius {}.\n",
+                      cr->GetName(), GetName(), dist, look_self, look_opp, linked, map->GetCrittersLookRadius() );
+        }
+    }
+}
+
 void Critter::ProcessVisibleItems()
 {
     if( IsDestroyed )
@@ -945,6 +1039,7 @@ void Critter::SetItem( Item* item )
         item->SetCritSlot( 0 );
     item->SetAccessory( ITEM_ACCESSORY_CRITTER );
     item->SetCritId( Id );
+    EntityMngr.AddCritterItem( Id, item );
 }
 
 void Critter::EraseItem( Item* item, bool send )
@@ -956,6 +1051,7 @@ void Critter::EraseItem( Item* item, bool send )
     invItems.erase( it );
 
     item->SetAccessory( ITEM_ACCESSORY_NONE );
+    EntityMngr.EraseCritterItem( Id, item );
 
     if( send )
         Send_EraseItem( item );
@@ -1294,16 +1390,123 @@ void Critter::Send_PlaySound( uint crid_synchronize, const string& sound_name )
         ( (Client*) this )->Send_PlaySound( crid_synchronize, sound_name );
 }
 
+void Critter::Send_Frame( NetFrame& frame )
+{
+    if( IsPlayer() )
+        ( (Client*) this )->Send_Frame( frame );
+}
+
+// Message writers, shared by single sends to connection buffer and broadcasts to frame
+template< class TBuf >
+static void WritePropertyMessage( TBuf& buf, NetProperty::Type type, Property* prop, Entity* entity )
+{
+    uint additional_args = 0;
+    switch( type )
+    {
+    case NetProperty::Critter:
+        additional_args = 1;
+        break;
+    case NetProperty::MapItem:
+        additional_args = 1;
+        break;
+    case NetProperty::CritterItem:
+        additional_args = 2;
+        break;
+    case NetProperty::ChosenItem:
+        additional_args = 1;
+        break;
+    default:
+        break;
+    }
+
+    uint  data_size;
+    void* data = prop->GetRawData( entity, data_size );
+
+    if( prop->IsPOD() )
+    {
+        buf << NETMSG_POD_PROPERTY( data_size, additional_args );
+    }
+    else
+    {
+        uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( char ) + additional_args * sizeof( uint ) + sizeof( ushort ) + data_size;
+        buf << NETMSG_COMPLEX_PROPERTY;
+        buf << msg_len;
+    }
+
+    buf << (char) type;
+
+    switch( type )
+    {
+    case NetProperty::CritterItem:
+        buf << ( (Item*) entity )->GetCritId();
+        buf << entity->Id;
+        break;
+    case NetProperty::Critter:
+        buf << entity->Id;
+        break;
+    case NetProperty::MapItem:
+        buf << entity->Id;
+        break;
+    case NetProperty::ChosenItem:
+        buf << entity->Id;
+        break;
+    default:
+        break;
+    }
+
+    buf << (ushort) prop->GetRegIndex();
+    if( data_size )
+        buf.Push( data, data_size );
+}
+
+template< class TBuf >
+static void WriteMoveMessage( TBuf& buf, Critter* from_cr, uint move_params )
+{
+    buf << NETMSG_CRITTER_MOVE;
+    buf << from_cr->GetId();
+    buf << move_params;
+    buf << from_cr->GetHexX();
+    buf << from_cr->GetHexY();
+}
+
+template< class TBuf >
+static void WriteXYMessage( TBuf& buf, Critter* cr )
+{
+    buf << NETMSG_CRITTER_XY;
+    buf << cr->GetId();
+    buf << cr->GetHexX();
+    buf << cr->GetHexY();
+    buf << cr->GetDir();
+}
+
+template< class TBuf >
+static void WriteTextMessage( TBuf& buf, uint from_id, const string& text, uchar how_say, bool unsafe_text )
+{
+    uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( from_id ) + sizeof( how_say ) +
+                   NetBuffer::StringLenSize + (uint) text.length() + sizeof( unsafe_text );
+
+    buf << NETMSG_CRITTER_TEXT;
+    buf << msg_len;
+    buf << from_id;
+    buf << how_say;
+    buf << text;
+    buf << unsafe_text;
+}
+
 void Critter::SendA_Property( NetProperty::Type type, Property* prop, Entity* entity )
 {
     if( VisCr.empty() )
         return;
 
-    for( auto it = VisCr.begin(), end = VisCr.end(); it != end; ++it )
+    NetFrame frame;
+    for( Critter* cr : VisCr )
     {
-        Critter* cr = *it;
         if( cr->IsPlayer() )
-            cr->Send_Property( type, prop, entity );
+        {
+            if( frame.IsEmpty() )
+                WritePropertyMessage( frame, type, prop, entity );
+            cr->Send_Frame( frame );
+        }
     }
 }
 
@@ -1312,11 +1515,15 @@ void Critter::SendA_Move( uint move_params )
     if( VisCr.empty() )
         return;
 
-    for( auto it = VisCr.begin(), end = VisCr.end(); it != end; ++it )
+    NetFrame frame;
+    for( Critter* cr : VisCr )
     {
-        Critter* cr = *it;
         if( cr->IsPlayer() )
-            cr->Send_Move( this, move_params );
+        {
+            if( frame.IsEmpty() )
+                WriteMoveMessage( frame, this, move_params );
+            cr->Send_Frame( frame );
+        }
     }
 }
 
@@ -1325,11 +1532,15 @@ void Critter::SendA_XY()
     if( VisCr.empty() )
         return;
 
-    for( auto it = VisCr.begin(), end = VisCr.end(); it != end; ++it )
+    NetFrame frame;
+    for( Critter* cr : VisCr )
     {
-        Critter* cr = *it;
         if( cr->IsPlayer() )
-            cr->Send_XY( this );
+        {
+            if( frame.IsEmpty() )
+                WriteXYMessage( frame, this );
+            cr->Send_Frame( frame );
+        }
     }
 }
 
@@ -1429,15 +1640,18 @@ void Critter::SendAA_Text( const CritterVec& to_cr, const string& text, uchar ho
     else if( how_say == SAY_WHISP || how_say == SAY_WHISP_ON_HEAD )
         dist = GameOpt.WhisperDist + GetMultihex();
 
+    NetFrame frame;
     for( Critter* cr : to_cr )
     {
         if( cr == this || !cr->IsPlayer() )
             continue;
 
-        if( dist == -1 )
-            cr->Send_TextEx( from_id, text, how_say, unsafe_text );
-        else if( CheckDist( GetHexX(), GetHexY(), cr->GetHexX(), cr->GetHexY(), dist + cr->GetMultihex() ) )
-            cr->Send_TextEx( from_id, text, how_say, unsafe_text );
+        if( dist == -1 || CheckDist( GetHexX(), GetHexY(), cr->GetHexX(), cr->GetHexY(), dist + cr->GetMultihex() ) )
+        {
+            if( frame.IsEmpty() )
+                WriteTextMessage( frame, from_id, text, how_say, unsafe_text );
+            cr->Send_Frame( frame );
+        }
     }
 }
 
@@ -1705,80 +1919,147 @@ void Critter::EraseKnownLoc( uint loc_id )
 /* Misc events                                                          */
 /************************************************************************/
 
+CrTimeEventVec& Critter::GetCrTimeEvents()
+{
+    if( !timeEventsLoaded )
+    {
+        timeEventsLoaded = true;
+
+        CScriptArray* te_next_time = GetTE_NextTime();
+        CScriptArray* te_func_num = GetTE_FuncNum();
+        CScriptArray* te_rate = GetTE_Rate();
+        CScriptArray* te_identifier = GetTE_Identifier();
+        RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
+        RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
+        RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
+
+        timeEvents.resize( te_next_time->GetSize() );
+        for( uint i = 0, j = te_next_time->GetSize(); i < j; i++ )
+        {
+            CrTimeEvent& te = timeEvents[ i ];
+            te.FuncNum = *(hash*) te_func_num->At( i );
+            te.Rate = *(uint*) te_rate->At( i );
+            te.NextTime = *(uint*) te_next_time->At( i );
+            te.Identifier = *(int*) te_identifier->At( i );
+        }
+
+        te_next_time->Release();
+        te_func_num->Release();
+        te_rate->Release();
+        te_identifier->Release();
+    }
+    return timeEvents;
+}
+
 void Critter::AddCrTimeEvent( hash func_num, uint rate, uint duration, int identifier )
 {
     if( duration )
         duration += GameOpt.FullSecond;
 
-    CScriptArray* te_next_time = GetTE_NextTime();
-    CScriptArray* te_func_num = GetTE_FuncNum();
-    CScriptArray* te_rate = GetTE_Rate();
-    CScriptArray* te_identifier = GetTE_Identifier();
-    RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
-    RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
-    RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
-
-    uint i = 0;
-    for( uint j = te_func_num->GetSize(); i < j; i++ )
-        if( duration < *(uint*) te_next_time->At( i ) )
-            break;
-
-    te_next_time->InsertAt( i, &duration );
-    te_func_num->InsertAt( i, &func_num );
-    te_rate->InsertAt( i, &rate );
-    te_identifier->InsertAt( i, &identifier );
+    CrTimeEventVec& time_events = GetCrTimeEvents();
+    auto            it = std::upper_bound( time_events.begin(), time_events.end(), duration, [] ( uint next_time, const CrTimeEvent& te ) { return next_time < te.NextTime; } );
+    time_events.insert( it, { func_num, rate, duration, identifier } );
+    TimeEventsChanged();
+}
 
-    SetTE_NextTime( te_next_time );
-    SetTE_FuncNum( te_func_num );
-    SetTE_Rate( te_rate );
-    SetTE_Identifier( te_identifier );
+void Critter::EraseCrTimeEvent( int index )
+{
+    CrTimeEventVec& time_events = GetCrTimeEvents();
+    if( index < (int) time_events.size() )
+    {
+        time_events.erase( time_events.begin() + index );
+        TimeEventsChanged();
+    }
+}
 
-    te_next_time->Release();
-    te_func_num->Release();
-    te_rate->Release();
-    te_identifier->Release();
+uint Critter::EraseCrTimeEvents( const IntVec& identifiers )
+{
+    CrTimeEventVec& time_events = GetCrTimeEvents();
+    auto            it = std::remove_if( time_events.begin(), time_events.end(), [ &identifiers ] ( const CrTimeEvent& te )
+                                         {
+                                             return std::find( identifiers.begin(), identifiers.end(), te.Identifier ) != identifiers.end();
+                                         } );
+    uint result = (uint) std::distance( it, time_events.end() );
+    if( result )
+    {
+        time_events.erase( it, time_events.end() );
+        TimeEventsChanged();
+    }
+    return result;
 }
 
-void Critter::EraseCrTimeEvent( int index )
+void Critter::ContinueTimeEvents( int offs_time )
 {
-    CScriptArray* te_next_time = GetTE_NextTime();
-    CScriptArray* te_func_num = GetTE_FuncNum();
-    CScriptArray* te_rate = GetTE_Rate();
-    CScriptArray* te_identifier = GetTE_Identifier();
-    RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
-    RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
-    RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
+    CrTimeEventVec& time_events = GetCrTimeEvents();
+    if( !time_events.empty() )
+    {
+        for( CrTimeEvent& te : time_events )
+            te.NextTime += offs_time;
+        TimeEventsChanged();
+    }
+}
 
-    if( index < (int) te_next_time->GetSize() )
+void Critter::TimeEventsChanged()
+{
+    if( !timeEventsChanged )
     {
-        te_next_time->RemoveAt( index );
-        te_func_num->RemoveAt( index );
-        te_rate->RemoveAt( index );
-        te_identifier->RemoveAt( index );
+        timeEventsChanged = true;
+        AddRef();
+        timeEventsChangedCritters.push_back( this );
+    }
+}
+
+void Critter::FlushCrTimeEvents()
+{
+    if( !timeEventsChanged )
+        return;
+
+    timeEventsChanged = false;
 
-        SetTE_NextTime( te_next_time );
-        SetTE_FuncNum( te_func_num );
-        SetTE_Rate( te_rate );
-        SetTE_Identifier( te_identifier );
+    UIntVec next_times, rates;
+    HashVec func_nums;
+    IntVec  identifiers;
+    next_times.reserve( timeEvents.size() );
+    func_nums.reserve( timeEvents.size() );
+    rates.reserve( timeEvents.size() );
+    identifiers.reserve( timeEvents.size() );
+    for( CrTimeEvent& te : timeEvents )
+    {
+        next_times.push_back( te.NextTime );
+        func_nums.push_back( te.FuncNum );
+        rates.push_back( te.Rate );
+        identifiers.push_back( te.Identifier );
     }
 
+    CScriptArray* te_next_time = Script::CreateArray( "uint[]" );
+    CScriptArray* te_func_num = Script::CreateArray( "hash[]" );
+    CScriptArray* te_rate = Script::CreateArray( "uint[]" );
+    CScriptArray* te_identifier = Script::CreateArray( "int[]" );
+    Script::AppendVectorToArray( next_times, te_next_time );
+    Script::AppendVectorToArray( func_nums, te_func_num );
+    Script::AppendVectorToArray( rates, te_rate );
+    Script::AppendVectorToArray( identifiers, te_identifier );
+
+    SetTE_NextTime( te_next_time );
+    SetTE_FuncNum( te_func_num );
+    SetTE_Rate( te_rate );
+    SetTE_Identifier( te_identifier );
+
     te_next_time->Release();
     te_func_num->Release();
     te_rate->Release();
     te_identifier->Release();
 }
 
-void Critter::ContinueTimeEvents( int offs_time )
+void Critter::FlushChangedCrTimeEvents()
 {
-    CScriptArray* te_next_time = GetTE_NextTime();
-    if( te_next_time->GetSize() > 0 )
+    CritterVec critters;
+    critters.swap( timeEventsChangedCritters );
+    for( Critter* cr : critters )
     {
-        for( uint i = 0, j = te_next_time->GetSize(); i < j; i++ )
-            *(uint*) te_next_time->At( i ) += offs_time;
-
-        SetTE_NextTime( te_next_time );
+        cr->FlushCrTimeEvents();
+        cr->Release();
     }
-    te_next_time->Release();
 }
 
 /************************************************************************/
@@ -1795,7 +2076,9 @@ Client::Client( NetConnection* conn, ProtoCritter* proto ): Critter( 0, EntityTy
     LastSendedMapTick = 0;
     RadioMessageSended = 0;
     UpdateFileIndex = -1;
-    UpdateFilePortion = 0;
+    UpdateFileOffset = 0;
+    UpdateFileEnd = 0;
+    UpdateFileHandle = nullptr;
 
     CritterIsNpc = false;
     MEMORY_PROCESS( MEMORY_CLIENT, sizeof( Client ) + 40 + sizeof( Item ) * 2 );
@@ -1811,6 +2094,8 @@ Client::Client( NetConnection* conn, ProtoCritter* proto ): Critter( 0, EntityTy
 
 Client::~Client()
 {
+    if( UpdateFileHandle )
+        FileClose( UpdateFileHandle );
     SAFEDEL( Connection );
 }
 
@@ -2014,89 +2299,35 @@ void Client::Send_Property( NetProperty::Type type, Property* prop, Entity* enti
     if( IsSendDisabled() || IsOffline() )
         return;
 
-    uint additional_args = 0;
-    switch( type )
-    {
-    case NetProperty::Critter:
-        additional_args = 1;
-        break;
-    case NetProperty::MapItem:
-        additional_args = 1;
-        break;
-    case NetProperty::CritterItem:
-        additional_args = 2;
-        break;
-    case NetProperty::ChosenItem:
-        additional_args = 1;
-        break;
-    default:
-        break;
-    }
-
-    uint  data_size;
-    void* data = prop->GetRawData( entity, data_size );
+    BOUT_BEGIN( this );
+    WritePropertyMessage( Connection->Bout, type, prop, entity );
+    BOUT_END( this );
+}
 
-    bool  is_pod = prop->IsPOD();
-    if( is_pod )
-    {
-        BOUT_BEGIN( this );
-        Connection->Bout << NETMSG_POD_PROPERTY( data_size, additional_args );
-    }
-    else
-    {
-        uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( char ) + additional_args * sizeof( uint ) + sizeof( ushort ) + data_size;
-        BOUT_BEGIN( this );
-        Connection->Bout << NETMSG_COMPLEX_PROPERTY;
-        Connection->Bout << msg_len;
-    }
+void Client::Send_Move( Critter* from_cr, uint move_params )
+{
+    if( IsSendDisabled() || IsOffline() )
+        return;
 
-    Connection->Bout << (char) type;
+    BOUT_BEGIN( this );
+    WriteMoveMessage( Connection->Bout, from_cr, move_params );
+    BOUT_END( this );
+}
 
-    switch( type )
-    {
-    case NetProperty::CritterItem:
-        Connection->Bout << ( (Item*) entity )->GetCritId();
-        Connection->Bout << entity->Id;
-        break;
-    case NetProperty::Critter:
-        Connection->Bout << entity->Id;
-        break;
-    case NetProperty::MapItem:
-        Connection->Bout << entity->Id;
-        break;
-    case NetProperty::ChosenItem:
-        Connection->Bout << entity->Id;
-        break;
-    default:
-        break;
-    }
+void Client::MakePropertyFrame( NetFrame& frame, NetProperty::Type type, Property* prop, Entity* entity )
+{
+    RUNTIME_ASSERT( entity );
 
-    if( is_pod )
-    {
-        Connection->Bout << (ushort) prop->GetRegIndex();
-        Connection->Bout.Push( data, data_size );
-        BOUT_END( this );
-    }
-    else
-    {
-        Connection->Bout << (ushort) prop->GetRegIndex();
-        if( data_size )
-            Connection->Bout.Push( data, data_size );
-        BOUT_END( this );
-    }
+    WritePropertyMessage( frame, type, prop, entity );
 }
 
-void Client::Send_Move( Critter* from_cr, uint move_params )
+void Client::Send_Frame( NetFrame& frame )
 {
     if( IsSendDisabled() || IsOffline() )
         return;
 
     BOUT_BEGIN( this );
-    Connection->Bout << NETMSG_CRITTER_MOVE;
-    Connection->Bout << from_cr->GetId();
-    Connection->Bout << move_params;
-    Connection->Bout << from_cr->GetHexX();
-    Connection->Bout << from_cr->GetHexY();
+    Connection->Bout.Push( frame );
     BOUT_END( this );
 }
 
@@ -2463,11 +2694,7 @@ void Client::Send_XY( Critter* cr )
         return;
 
     BOUT_BEGIN( this );
-    Connection->Bout << NETMSG_CRITTER_XY;
-    Connection->Bout << cr->GetId();
-    Connection->Bout << cr->GetHexX();
-    Connection->Bout << cr->GetHexY();
-    Connection->Bout << cr->GetDir();
+    WriteXYMessage( Connection->Bout, cr );
     BOUT_END( this );
 }
 
@@ -2612,16 +2839,8 @@ void Client::Send_TextEx( uint from_id, const string& text, uchar how_say, bool
     if( IsSendDisabled() || IsOffline() )
         return;
 
-    uint msg_len = sizeof( uint ) + sizeof( msg_len ) + sizeof( from_id ) + sizeof( how_say ) +
-                   NetBuffer::StringLenSize + (uint) text.length() + sizeof( unsafe_text );
-
     BOUT_BEGIN( this );
-    Connection->Bout << NETMSG_CRITTER_TEXT;
-    Connection->Bout << msg_len;
-    Connection->Bout << from_id;
-    Connection->Bout << how_say;
-    Connection->Bout << text;
-    Connection->Bout << unsafe_text;
+    WriteTextMessage( Connection->Bout, from_id, text, how_say, unsafe_text );
     BOUT_END( this );
 }
 
@@ -28,6 +28,15 @@ typedef vector< Critter* >    CritterVec;
 typedef vector< Client* >     ClVec;
 typedef vector< Npc* >        PcVec;
 
+struct CrTimeEvent
+{
+    hash FuncNum;
+    uint Rate;
+    uint NextTime;
+    int  Identifier;
+};
+typedef vector< CrTimeEvent > CrTimeEventVec;
+
 class Critter: public Entity
 {
 public:
@@ -68,14 +77,14 @@ public:
     CLASS_PROPERTY( CScriptArray *, TE_NextTime );   // uint
     CLASS_PROPERTY( CScriptArray *, TE_Identifier ); // int
     // ...
-    CLASS_PROPERTY( uint, LookDistance );
+    CLASS_VIRTUAL_PROPERTY( uint, LookDistance );
     CLASS_PROPERTY( hash, DialogId );
     CLASS_PROPERTY( bool, IsNoTalk );
     CLASS_PROPERTY( int, MaxTalkers );   // Callback on begin dialog?
     CLASS_PROPERTY( uint, TalkDistance );
     CLASS_PROPERTY( int, CurrentHp );
-    CLASS_PROPERTY( bool, IsNoWalk );
-    CLASS_PROPERTY( bool, IsNoRun );
+    CLASS_VIRTUAL_PROPERTY( bool, IsNoWalk );
+    CLASS_VIRTUAL_PROPERTY( bool, IsNoRun );
     CLASS_PROPERTY( bool, IsNoRotate );
     CLASS_PROPERTY( uint, WalkTime );
     CLASS_PROPERTY( uint, RunTime );
@@ -97,7 +106,7 @@ public:
     CLASS_PROPERTY( uint, ShowCritterDist2 );
     CLASS_PROPERTY( uint, ShowCritterDist3 );
     CLASS_PROPERTY( hash, ScriptId );
-    CLASS_PROPERTY( int, SneakCoefficient );
+    CLASS_VIRTUAL_PROPERTY( int, SneakCoefficient );
     // Exclude
     CLASS_PROPERTY( hash, NpcRole );            // Find Npc criteria (maybe swap to some universal prop/value array as input)
     CLASS_PROPERTY( bool, IsNoUnarmed );        // AI
@@ -126,6 +135,8 @@ public:
     CritterMap VisCrMap;
     CritterMap VisCrSelfMap;
     UIntSet    VisCr1, VisCr2, VisCr3;
+    uint       VisProcessMapId;
+    ushort     VisProcessHexX, VisProcessHexY;
     UIntSet    VisItem;
     Mutex      VisItemLocker;
     uint       ViewMapId;
@@ -137,6 +148,8 @@ public:
     Map* GetMap();
 
     void ProcessVisibleCritters();
+    void GetVisibleCandidates( Map* map, CritterVec& critters );
+    void VerifyVisibleCandidates( Map* map, CritterVec& critters );
     void ProcessVisibleItems();
     void ViewMap( Map* map, int look, ushort hx, ushort hy, int dir );
     void ClearVisible();
@@ -254,6 +267,7 @@ public:
     void Send_Effect( hash eff_pid, ushort hx, ushort hy, ushort radius );
     void Send_FlyEffect( hash eff_pid, uint from_crid, uint to_crid, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy );
     void Send_PlaySound( uint crid_synchronize, const string& sound_name );
+    void Send_Frame( NetFrame& frame );
 
     // Send all
     void SendA_Property( NetProperty::Type type, Property* prop, Entity* entity );
@@ -294,9 +308,23 @@ public:
     void EraseKnownLoc( uint loc_id );
 
     // Time events
-    void AddCrTimeEvent( hash func_num, uint rate, uint duration, int identifier );
-    void EraseCrTimeEvent( int index );
-    void ContinueTimeEvents( int offs_time );
+    // Native copy of TE_* properties sorted by next time, properties updated once per cycle
+private:
+    CrTimeEventVec    timeEvents;
+    bool              timeEventsLoaded;
+    bool              timeEventsChanged;
+    static CritterVec timeEventsChangedCritters;
+
+    void TimeEventsChanged();
+
+public:
+    CrTimeEventVec& GetCrTimeEvents();
+    void            AddCrTimeEvent( hash func_num, uint rate, uint duration, int identifier );
+    void            EraseCrTimeEvent( int index );
+    uint            EraseCrTimeEvents( const IntVec& identifiers );
+    void            ContinueTimeEvents( int offs_time );
+    void            FlushCrTimeEvents();
+    static void     FlushChangedCrTimeEvents();
 
     // Other
     CritterVec* GlobalMapGroup;
@@ -304,9 +332,9 @@ public:
 };
 
 #define BIN_BEGIN( cl_ )     cl_->Connection->Bin.Lock()
-#define BIN_END( cl_ )       cl_->Connection->Bin.Unlock()
-#define BOUT_BEGIN( cl_ )    cl_->Connection->Bout.Lock()
-#define BOUT_END( cl_ )      cl_->Connection->Bout.Unlock(); cl_->Connection->Dispatch()
+#define BIN_END( cl_ )       cl_->Connection->EndProcessing(); cl_->Connection->Bin.Unlock()
+#define BOUT_BEGIN( cl_ )    cl_->Connection->BeginMessage()
+#define BOUT_END( cl_ )      cl_->Connection->EndMessage()
 
 class Client: public Critter
 {
@@ -324,7 +352,9 @@ public:
     uint           LastSayEqualCount;
     uint           RadioMessageSended;
     int            UpdateFileIndex;
-    uint           UpdateFilePortion;
+    uint           UpdateFileOffset;
+    uint           UpdateFileEnd;
+    void*          UpdateFileHandle;
 
 public:
     uint        GetIp();
@@ -383,6 +413,7 @@ public:
     void Send_Effect( hash eff_pid, ushort hx, ushort hy, ushort radius );
     void Send_FlyEffect( hash eff_pid, uint from_crid, uint to_crid, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy );
     void Send_PlaySound( uint crid_synchronize, const string& sound_name );
+    void Send_Frame( NetFrame& frame );                                   // Message serialized once for many clients
     void Send_MapText( ushort hx, ushort hy, uint color, const string& text, bool unsafe_text );
     void Send_MapTextMsg( ushort hx, ushort hy, uint color, ushort num_msg, uint num_str );
     void Send_MapTextMsgLex( ushort hx, ushort hy, uint color, ushort num_msg, uint num_str, const char* lexems, ushort lexems_len );
@@ -391,6 +422,9 @@ public:
     void Send_CustomMessage( uint msg );
     void Send_CustomMessage( uint msg, uchar* data, uint data_size );
 
+    // Broadcast frames
+    static void MakePropertyFrame( NetFrame& frame, NetProperty::Type type, Property* prop, Entity* entity );
+
     // Dialogs
 private:
     uint talkNextTick;
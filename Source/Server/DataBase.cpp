@@ -4,9 +4,11 @@
 #include "FileUtils.h"
 #include "FileSystem.h"
 #include "StringUtils.h"
+#include "Timer.h"
 #include "unqlite.h"
 #include "mongoc.h"
 #include "json.hpp"
+#include "zlib.h"
 
 DataBase* DbStorage;
 DataBase* DbHistory;
@@ -335,6 +337,14 @@ static void BsonToDocument( const bson_t* bson, DataBase::Document& doc )
     }
 }
 
+UIntVec DataBase::GetAllIds( const string& collection_name )
+{
+    FlushWrites();
+
+    SCOPE_LOCK( recordsLocker );
+    return GetAllRecordIds( collection_name );
+}
+
 DataBase::Document DataBase::Get( const string& collection_name, uint id )
 {
     if( deletedRecords[ collection_name ].count( id ) )
@@ -343,7 +353,39 @@ DataBase::Document DataBase::Get( const string& collection_name, uint id )
     if( newRecords[ collection_name ].count( id ) )
         return recordChanges[ collection_name ][ id ];
 
-    Document doc = GetRecord( collection_name, id );
+    Document doc;
+    {
+        // Writer thread holds records lock until committed changes leave queue
+        SCOPE_LOCK( recordsLocker );
+        doc = GetRecord( collection_name, id );
+
+        if( writeBehind )
+        {
+            std::lock_guard< std::mutex > queue_lock( writeQueueLocker );
+            for( Changes& changes : writeQueue )
+            {
+                auto it_deleted = changes.DeletedRecords.find( collection_name );
+                if( it_deleted != changes.DeletedRecords.end() && it_deleted->second.count( id ) )
+                {
+                    doc.clear();
+                    continue;
+                }
+
+                auto it_collection = changes.RecordChanges.find( collection_name );
+                if( it_collection == changes.RecordChanges.end() )
+                    continue;
+                auto it_record = it_collection->second.find( id );
+                if( it_record == it_collection->second.end() )
+                    continue;
+
+                auto it_new = changes.NewRecords.find( collection_name );
+                if( it_new != changes.NewRecords.end() && it_new->second.count( id ) )
+                    doc.clear();
+                for( auto& kv : it_record->second )
+                    doc[ kv.first ] = kv.second;
+            }
+        }
+    }
 
     if( recordChanges[ collection_name ].count( id ) )
     {
@@ -364,23 +406,33 @@ void DataBase::StartChanges()
     changesStarted = true;
 }
 
-void DataBase::Insert( const string& collection_name, uint id, const Document& doc )
+void DataBase::Insert( const string& collection_name, uint id, Document doc )
 {
     RUNTIME_ASSERT( changesStarted );
     RUNTIME_ASSERT( !newRecords[ collection_name ].count( id ) );
     RUNTIME_ASSERT( !deletedRecords[ collection_name ].count( id ) );
 
     newRecords[ collection_name ].insert( id );
-    for( auto& kv : doc )
-        recordChanges[ collection_name ][ id ][ kv.first ] = kv.second;
+
+    // Take whole document if no changes made before insertion
+    Document& record = recordChanges[ collection_name ][ id ];
+    if( record.empty() )
+    {
+        record = std::move( doc );
+    }
+    else
+    {
+        for( auto& kv : doc )
+            record[ kv.first ] = std::move( kv.second );
+    }
 }
 
-void DataBase::Update( const string& collection_name, uint id, const string& key, const Value& value )
+void DataBase::Update( const string& collection_name, uint id, const string& key, Value value )
 {
     RUNTIME_ASSERT( changesStarted );
     RUNTIME_ASSERT( !deletedRecords[ collection_name ].count( id ) );
 
-    recordChanges[ collection_name ][ id ][ key ] = value;
+    recordChanges[ collection_name ][ id ][ key ] = std::move( value );
 }
 
 void DataBase::Delete( const string& collection_name, uint id )
@@ -399,27 +451,124 @@ void DataBase::CommitChanges()
 
     changesStarted = false;
 
-    for( auto& collection : recordChanges )
+    Changes changes;
+    changes.RecordChanges.swap( recordChanges );
+    changes.NewRecords.swap( newRecords );
+    changes.DeletedRecords.swap( deletedRecords );
+
+    if( writeBehind )
+    {
+        if( changes.RecordChanges.empty() && changes.DeletedRecords.empty() )
+            return;
+
+        // Back pressure
+        std::unique_lock< std::mutex > queue_lock( writeQueueLocker );
+        writeQueueSignal.wait( queue_lock, [ this ] () { return writeQueue.size() < writeQueueMaxSize; } );
+        writeQueue.push_back( std::move( changes ) );
+        if( (uint) writeQueue.size() > writeQueuePeak )
+            writeQueuePeak = (uint) writeQueue.size();
+        queue_lock.unlock();
+        writeQueueSignal.notify_all();
+    }
+    else
+    {
+        SCOPE_LOCK( recordsLocker );
+        CommitChanges( changes );
+    }
+}
+
+void DataBase::CommitChanges( Changes& changes )
+{
+    double commit_begin = Timer::AccurateTick();
+
+    for( auto& collection : changes.RecordChanges )
     {
         for( auto& data : collection.second )
         {
-            auto it = newRecords.find( collection.first );
-            if( it != newRecords.end() && it->second.count( data.first ) )
+            auto it = changes.NewRecords.find( collection.first );
+            if( it != changes.NewRecords.end() && it->second.count( data.first ) )
                 InsertRecord( collection.first, data.first, data.second );
             else
                 UpdateRecord( collection.first, data.first, data.second );
         }
     }
 
-    for( auto& collection : deletedRecords )
+    for( auto& collection : changes.DeletedRecords )
         for( auto & id : collection.second )
             DeleteRecord( collection.first, id );
 
-    recordChanges.clear();
-    newRecords.clear();
-    deletedRecords.clear();
-
     CommitRecords();
+
+    double commit_time = Timer::AccurateTick() - commit_begin;
+    commitTime = commit_time;
+    if( commit_time > commitTimeMax )
+        commitTimeMax = commit_time;
+}
+
+void DataBase::StartWriteBehind( uint max_queue_size )
+{
+    RUNTIME_ASSERT( !writeBehind );
+    RUNTIME_ASSERT( max_queue_size > 0 );
+
+    writeBehind = true;
+    writeFinish = false;
+    writeQueueMaxSize = max_queue_size;
+    writeThread.Start( [ this ] ( void* ) { WriteLoop(); }, "DataBaseWriter" );
+}
+
+void DataBase::StopWriteBehind()
+{
+    if( !writeBehind )
+        return;
+
+    // Writer thread commits all queued changes before exit
+    {
+        std::lock_guard< std::mutex > queue_lock( writeQueueLocker );
+        writeFinish = true;
+    }
+    writeQueueSignal.notify_all();
+    writeThread.Wait();
+
+    RUNTIME_ASSERT( writeQueue.empty() );
+    writeBehind = false;
+}
+
+void DataBase::FlushWrites()
+{
+    if( !writeBehind )
+        return;
+
+    std::unique_lock< std::mutex > queue_lock( writeQueueLocker );
+    writeQueueSignal.wait( queue_lock, [ this ] () { return writeQueue.empty(); } );
+}
+
+uint DataBase::GetWriteQueueSize()
+{
+    std::lock_guard< std::mutex > queue_lock( writeQueueLocker );
+    return (uint) writeQueue.size();
+}
+
+void DataBase::WriteLoop()
+{
+    while( true )
+    {
+        std::unique_lock< std::mutex > queue_lock( writeQueueLocker );
+        writeQueueSignal.wait( queue_lock, [ this ] () { return !writeQueue.empty() || writeFinish; } );
+        if( writeQueue.empty() )
+            break;
+
+        // Deque references stay valid while game thread appends new changes
+        Changes& changes = writeQueue.front();
+        queue_lock.unlock();
+
+        SCOPE_LOCK( recordsLocker );
+        CommitChanges( changes );
+
+        queue_lock.lock();
+        writeQueue.pop_front();
+        queue_lock.unlock();
+        writeQueueSignal.notify_all();
+    }
 }
 
 class DbJson: public DataBase
@@ -436,7 +585,7 @@ public:
         return db_json;
     }
 
-    virtual UIntVec GetAllIds( const string& collection_name ) override
+    virtual UIntVec GetAllRecordIds( const string& collection_name ) override
     {
         UIntVec ids;
         StrVec  paths;
@@ -607,7 +756,7 @@ public:
         collections.clear();
     }
 
-    virtual UIntVec GetAllIds( const string& collection_name ) override
+    virtual UIntVec GetAllRecordIds( const string& collection_name ) override
     {
         unqlite* db = GetCollection( collection_name );
         RUNTIME_ASSERT( db );
@@ -826,7 +975,7 @@ public:
         mongoc_cleanup();
     }
 
-    virtual UIntVec GetAllIds( const string& collection_name ) override
+    virtual UIntVec GetAllRecordIds( const string& collection_name ) override
     {
         mongoc_collection_t* collection = GetCollection( collection_name );
         RUNTIME_ASSERT( collection );
@@ -1010,7 +1159,7 @@ public:
         return new DbMemory();
     }
 
-    virtual UIntVec GetAllIds( const string& collection_name ) override
+    virtual UIntVec GetAllRecordIds( const string& collection_name ) override
     {
         Collection& collection = collections[ collection_name ];
 
@@ -1070,6 +1219,456 @@ protected:
     }
 };
 
+class DbLogStore: public DataBase
+{
+    // Record: uint payload size, uint payload crc32, payload
+    // Payload: uchar operation, ushort collection name length, collection name, uint id, bson delta
+    struct RecordPos
+    {
+        uint Segment;
+        uint Offset;
+        uint Size;
+    };
+    using RecordChain = vector< RecordPos >;
+    using CollectionIndex = map< uint, RecordChain >;
+
+    static const uchar InsertOp = 0;
+    static const uchar UpdateOp = 1;
+    static const uchar DeleteOp = 2;
+    static const uint  HeaderSize = sizeof( uint ) * 2;
+    static const uint  SegmentMaxSize = 64 * 1024 * 1024;
+    static const uint  CompactionMinSize = 16 * 1024 * 1024;
+    static const uint  CompactionStepSize = 1024 * 1024;
+    static const uint  ChainMaxLength = 16;
+
+    string                         storageDir;
+    map< string, CollectionIndex > index;
+    map< uint, uint >              segmentSizes;
+    map< uint, void* >             segmentReaders;
+    uint                           activeSegment = 0;
+    void*                          activeWriter = nullptr;
+    uint64                         liveSize = 0;
+    uint64                         totalSize = 0;
+    UCharVec                       payloadBuf;
+    uint                           compactSegment = 0; // Last segment to be removed by running compaction
+    string                         compactCollection;
+    uint                           compactId = 0;
+
+public:
+    static DbLogStore* Create( const string& storage_dir )
+    {
+        File::CreateDirectoryTree( storage_dir + "/" );
+
+        DbLogStore* db_log_store = new DbLogStore();
+        db_log_store->storageDir = storage_dir;
+        if( !db_log_store->Recover() )
+        {
+            delete db_log_store;
+            return nullptr;
+        }
+
+        // Whole compaction before game, during game it goes by steps on commits
+        if( db_log_store->IsCompactionNeeded() )
+        {
+            db_log_store->BeginCompaction();
+            db_log_store->CompactStep( uint64( -1 ) );
+        }
+        return db_log_store;
+    }
+
+    ~DbLogStore()
+    {
+        if( activeWriter )
+            FileClose( activeWriter );
+        for( auto& kv : segmentReaders )
+            FileClose( kv.second );
+        segmentReaders.clear();
+    }
+
+    virtual UIntVec GetAllRecordIds( const string& collection_name ) override
+    {
+        CollectionIndex& collection = index[ collection_name ];
+
+        UIntVec          ids;
+        ids.reserve( collection.size() );
+        for( auto& kv : collection )
+            ids.push_back( kv.first );
+
+        return ids;
+    }
+
+protected:
+    virtual Document GetRecord( const string& collection_name, uint id ) override
+    {
+        CollectionIndex& collection = index[ collection_name ];
+
+        auto             it = collection.find( id );
+        return it != collection.end() ? ReadDocument( it->second ) : Document();
+    }
+
+    virtual void InsertRecord( const string& collection_name, uint id, const Document& doc ) override
+    {
+        RUNTIME_ASSERT( !doc.empty() );
+
+        CollectionIndex& collection = index[ collection_name ];
+        RUNTIME_ASSERT( !collection.count( id ) );
+
+        RecordPos pos = WriteRecord( InsertOp, collection_name, id, &doc );
+        collection[ id ].push_back( pos );
+        liveSize += HeaderSize + pos.Size;
+    }
+
+    virtual void UpdateRecord( const string& collection_name, uint id, const Document& doc ) override
+    {
+        RUNTIME_ASSERT( !doc.empty() );
+
+        CollectionIndex& collection = index[ collection_name ];
+
+        auto             it = collection.find( id );
+        RUNTIME_ASSERT( it != collection.end() );
+
+        // Long chain folded to single insert, superseded records become dead and reads stay short
+        if( it->second.size() >= ChainMaxLength )
+        {
+            Document full_doc = ReadDocument( it->second );
+            for( auto& kv : doc )
+                full_doc[ kv.first ] = kv.second;
+
+            RecordPos pos = WriteRecord( InsertOp, collection_name, id, &full_doc );
+            liveSize -= GetChainSize( it->second );
+            it->second.clear();
+            it->second.push_back( pos );
+            liveSize += HeaderSize + pos.Size;
+            return;
+        }
+
+        // Only changed values goes to log, full document assembled on read
+        RecordPos pos = WriteRecord( UpdateOp, collection_name, id, &doc );
+        it->second.push_back( pos );
+        liveSize += HeaderSize + pos.Size;
+    }
+
+    virtual void DeleteRecord( const string& collection_name, uint id ) override
+    {
+        CollectionIndex& collection = index[ collection_name ];
+
+        auto             it = collection.find( id );
+        RUNTIME_ASSERT( it != collection.end() );
+
+        WriteRecord( DeleteOp, collection_name, id, nullptr );
+        liveSize -= GetChainSize( it->second );
+        collection.erase( it );
+    }
+
+    virtual void CommitRecords() override
+    {
+        // Commit is durable after sync, appended data also flushed before next reads
+        CloseWriter();
+
+        // Compaction split to steps to keep commit time bounded
+        if( !compactSegment && IsCompactionNeeded() )
+            BeginCompaction();
+        if( compactSegment )
+            CompactStep( CompactionStepSize );
+    }
+
+private:
+    bool IsCompactionNeeded()
+    {
+        // Live size counts newest insert of each record plus its deltas, folded chains leave dead space
+        return totalSize >= CompactionMinSize && liveSize * 2 < totalSize;
+    }
+
+    void CloseWriter()
+    {
+        if( activeWriter )
+        {
+            if( !FileSync( activeWriter ) )
+                WriteLog( "LogStore : Can't sync segment {}.\n", activeSegment );
+            FileClose( activeWriter );
+            activeWriter = nullptr;
+        }
+    }
+
+    string GetSegmentPath( uint segment )
+    {
+        return File::GetWritePath( _str( "{}/{}.fologstore", storageDir, segment ) );
+    }
+
+    static uint64 GetChainSize( const RecordChain& chain )
+    {
+        uint64 size = 0;
+        for( const RecordPos& pos : chain )
+            size += HeaderSize + pos.Size;
+        return size;
+    }
+
+    bool Recover()
+    {
+        StrVec paths;
+        File::GetFolderFileNames( storageDir + "/", false, "fologstore", paths );
+
+        UIntVec segments;
+        for( const string& path : paths )
+        {
+            uint segment = _str( path ).extractFileName().eraseFileExtension().toUInt();
+            if( segment )
+                segments.push_back( segment );
+        }
+        std::sort( segments.begin(), segments.end() );
+
+        // Replay all segments in order, damaged tail of segment is skipped
+        for( uint segment : segments )
+        {
+            string path = GetSegmentPath( segment );
+            void*  f = FileOpen( path, false );
+            if( !f )
+            {
+                WriteLog( "LogStore : Can't open segment '{}'.\n", path );
+                return false;
+            }
+
+            uint file_size = FileGetSize( f );
+            uint offset = 0;
+            while( offset + HeaderSize <= file_size )
+            {
+                uint header[ 2 ];
+                if( !FileRead( f, header, HeaderSize ) || header[ 0 ] > file_size - offset - HeaderSize )
+                    break;
+
+                payloadBuf.resize( header[ 0 ] );
+                if( header[ 0 ] && !FileRead( f, &payloadBuf[ 0 ], header[ 0 ] ) )
+                    break;
+                if( (uint) crc32( 0, payloadBuf.data(), header[ 0 ] ) != header[ 1 ] )
+                    break;
+
+                uchar        op;
+                string       collection_name;
+                uint         id;
+                const uchar* bson_data;
+                uint         bson_len;
+                if( !ParsePayload( op, collection_name, id, bson_data, bson_len ) )
+                    break;
+
+                RecordPos        pos = { segment, offset + HeaderSize, header[ 0 ] };
+                CollectionIndex& collection = index[ collection_name ];
+                if( op == DeleteOp )
+                {
+                    auto it = collection.find( id );
+                    if( it != collection.end() )
+                    {
+                        liveSize -= GetChainSize( it->second );
+                        collection.erase( it );
+                    }
+                }
+                else
+                {
+                    RecordChain& chain = collection[ id ];
+                    if( op == InsertOp )
+                    {
+                        liveSize -= GetChainSize( chain );
+                        chain.clear();
+                    }
+                    chain.push_back( pos );
+                    liveSize += HeaderSize + pos.Size;
+                }
+
+                offset += HeaderSize + header[ 0 ];
+            }
+
+            if( offset != file_size )
+                WriteLog( "LogStore : Segment '{}' damaged at offset {}, skipped {} bytes.\n", path, offset, file_size - offset );
+
+            segmentSizes[ segment ] = file_size;
+            segmentReaders[ segment ] = f;
+            totalSize += file_size;
+        }
+
+        // Never append after possibly damaged tail
+        activeSegment = ( segments.empty() ? 0 : segments.back() ) + 1;
+        return true;
+    }
+
+    bool ParsePayload( uchar& op, string& collection_name, uint& id, const uchar*& bson_data, uint& bson_len )
+    {
+        uint size = (uint) payloadBuf.size();
+        if( size < sizeof( uchar ) + sizeof( ushort ) )
+            return false;
+
+        const uchar* data = payloadBuf.data();
+        op = data[ 0 ];
+        ushort       name_len;
+        memcpy( &name_len, data + 1, sizeof( name_len ) );
+        uint         pos = sizeof( uchar ) + sizeof( ushort );
+        if( op > DeleteOp || pos + name_len + sizeof( uint ) > size )
+            return false;
+
+        collection_name.assign( (const char*) data + pos, name_len );
+        pos += name_len;
+        memcpy( &id, data + pos, sizeof( id ) );
+        pos += sizeof( uint );
+        bson_data = data + pos;
+        bson_len = size - pos;
+        return op == DeleteOp || bson_len > 0;
+    }
+
+    RecordPos WriteRecord( uchar op, const string& collection_name, uint id, const Document* doc )
+    {
+        RUNTIME_ASSERT( collection_name.length() <= 0xFFFF );
+
+        ushort name_len = (ushort) collection_name.length();
+        payloadBuf.resize( sizeof( uchar ) + sizeof( ushort ) + name_len + sizeof( uint ) );
+        payloadBuf[ 0 ] = op;
+        memcpy( &payloadBuf[ 1 ], &name_len, sizeof( name_len ) );
+        memcpy( &payloadBuf[ 3 ], collection_name.c_str(), name_len );
+        memcpy( &payloadBuf[ 3 + name_len ], &id, sizeof( id ) );
+
+        if( doc )
+        {
+            bson_t bson;
+            bson_init( &bson );
+            DocumentToBson( *doc, &bson );
+
+            const uint8_t* bson_data = bson_get_data( &bson );
+            RUNTIME_ASSERT( bson_data );
+            payloadBuf.insert( payloadBuf.end(), bson_data, bson_data + bson.len );
+
+            bson_destroy( &bson );
+        }
+
+        // Roll to next segment
+        if( segmentSizes[ activeSegment ] >= SegmentMaxSize )
+        {
+            CloseWriter();
+            activeSegment++;
+        }
+
+        if( !activeWriter )
+        {
+            activeWriter = FileOpenForAppend( GetSegmentPath( activeSegment ) );
+            RUNTIME_ASSERT( activeWriter );
+        }
+
+        uint header[ 2 ] = { (uint) payloadBuf.size(), (uint) crc32( 0, payloadBuf.data(), (uint) payloadBuf.size() ) };
+        bool write_ok = FileWrite( activeWriter, header, HeaderSize ) && FileWrite( activeWriter, payloadBuf.data(), header[ 0 ] );
+        RUNTIME_ASSERT( write_ok );
+
+        uint&     segment_size = segmentSizes[ activeSegment ];
+        RecordPos pos = { activeSegment, segment_size + HeaderSize, header[ 0 ] };
+        segment_size += HeaderSize + header[ 0 ];
+        totalSize += HeaderSize + header[ 0 ];
+        return pos;
+    }
+
+    Document ReadDocument( const RecordChain& chain )
+    {
+        Document doc;
+        for( const RecordPos& pos : chain )
+        {
+            void*& f = segmentReaders[ pos.Segment ];
+            if( !f )
+            {
+                f = FileOpen( GetSegmentPath( pos.Segment ), false );
+                RUNTIME_ASSERT( f );
+            }
+
+            payloadBuf.resize( pos.Size );
+            bool read_ok = FileSetPointer( f, pos.Offset, SEEK_SET ) && FileRead( f, &payloadBuf[ 0 ], pos.Size );
+            RUNTIME_ASSERT( read_ok );
+
+            uchar        op;
+            string       collection_name;
+            uint         id;
+            const uchar* bson_data;
+            uint         bson_len;
+            bool         parse_ok = ParsePayload( op, collection_name, id, bson_data, bson_len );
+            RUNTIME_ASSERT( parse_ok );
+            RUNTIME_ASSERT( op != DeleteOp );
+
+            bson_t bson;
+            bool   init_static = bson_init_static( &bson, bson_data, bson_len );
+            RUNTIME_ASSERT( init_static );
+
+            Document delta;
+            BsonToDocument( &bson, delta );
+            for( auto& kv : delta )
+                doc[ kv.first ] = std::move( kv.second );
+        }
+        return doc;
+    }
+
+    void BeginCompaction()
+    {
+        WriteLog( "LogStore : Compaction, live {} of {} bytes.\n", liveSize, totalSize );
+
+        // Live documents rewritten as single inserts into new segments, replay of new segments overrides old ones
+        CloseWriter();
+        compactSegment = activeSegment;
+        compactCollection.clear();
+        compactId = 0;
+        activeSegment++;
+    }
+
+    void CompactStep( uint64 max_size )
+    {
+        // Cursor kept by keys, records added or deleted between steps not break it
+        uint64 size = 0;
+        for( auto it_collection = index.lower_bound( compactCollection ); it_collection != index.end(); ++it_collection )
+        {
+            CollectionIndex& collection = it_collection->second;
+            auto             it = ( it_collection->first == compactCollection ? collection.lower_bound( compactId ) : collection.begin() );
+            for( ; it != collection.end(); ++it )
+            {
+                if( size >= max_size )
+                {
+                    compactCollection = it_collection->first;
+                    compactId = it->first;
+                    return;
+                }
+
+                RecordChain& chain = it->second;
+                auto         it_old = std::find_if( chain.begin(), chain.end(), [ this ] ( const RecordPos& pos ) { return pos.Segment <= compactSegment; } );
+                if( it_old == chain.end() )
+                    continue;
+
+                Document  doc = ReadDocument( chain );
+                RecordPos pos = WriteRecord( InsertOp, it_collection->first, it->first, &doc );
+                liveSize -= GetChainSize( chain );
+                chain.clear();
+                chain.push_back( pos );
+                liveSize += HeaderSize + pos.Size;
+                size += HeaderSize + pos.Size;
+            }
+        }
+
+        // New segments must be on disk before old ones deleted
+        CloseWriter();
+
+        // Delete in ascending order, any remaining old segments on crash still replays correctly
+        for( auto it = segmentSizes.begin(); it != segmentSizes.end() && it->first <= compactSegment;)
+        {
+            auto it_reader = segmentReaders.find( it->first );
+            if( it_reader != segmentReaders.end() )
+            {
+                FileClose( it_reader->second );
+                segmentReaders.erase( it_reader );
+            }
+
+            string path = GetSegmentPath( it->first );
+            if( FileExist( path ) && !FileDelete( path ) )
+                WriteLog( "LogStore : Can't delete segment '{}'.\n", path );
+
+            totalSize -= it->second;
+            it = segmentSizes.erase( it );
+        }
+
+        compactSegment = 0;
+        compactCollection.clear();
+        compactId = 0;
+        WriteLog( "LogStore : Compaction complete, live {} of {} bytes.\n", liveSize, totalSize );
+    }
+};
+
 DataBase* GetDataBase( const string& connection_info )
 {
     auto options = _str( connection_info ).split( ' ' );
@@ -1079,6 +1678,8 @@ DataBase* GetDataBase( const string& connection_info )
         return DbUnQLite::Create( options[ 1 ] );
     else if( options[ 0 ] == "Mongo" && options.size() == 3 )
         return DbMongo::Create( options[ 1 ], options[ 2 ] );
+    else if( options[ 0 ] == "LogStore" && options.size() == 2 )
+        return DbLogStore::Create( options[ 1 ] );
     else if( options[ 0 ] == "Memory" && options.size() == 1 )
         return DbMemory::Create();
 
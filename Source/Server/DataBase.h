@@ -2,7 +2,10 @@
 #define _DATA_BASE_
 
 #include "Common.h"
+#include "Threading.h"
 #include "mapbox/variant.hpp"
+#include <condition_variable>
+#include <atomic>
 
 class DataBase
 {
@@ -24,12 +27,36 @@ public:
     using RecordsState = map< string, set< uint > >;
 
 private:
-    bool         changesStarted;
+    struct Changes
+    {
+        Collections  RecordChanges;
+        RecordsState NewRecords;
+        RecordsState DeletedRecords;
+    };
+
+    bool         changesStarted = false;
     Collections  recordChanges;
     RecordsState newRecords;
     RecordsState deletedRecords;
 
+    // Write behind
+    bool                    writeBehind = false;
+    bool                    writeFinish = false;
+    uint                    writeQueueMaxSize = 0;
+    deque< Changes >        writeQueue;
+    std::mutex              writeQueueLocker;
+    std::condition_variable writeQueueSignal;
+    Mutex                   recordsLocker;
+    Thread                  writeThread;
+    std::atomic< uint >     writeQueuePeak { 0 };   // Statistics, read from other threads
+    std::atomic< double >   commitTime { 0.0 };
+    std::atomic< double >   commitTimeMax { 0.0 };
+
+    void CommitChanges( Changes& changes );
+    void WriteLoop();
+
 protected:
+    virtual UIntVec  GetAllRecordIds( const string& collection_name ) = 0;
     virtual Document GetRecord( const string& collection_name, uint id ) = 0;
     virtual void     InsertRecord( const string& collection_name, uint id, const Document& doc ) = 0;
     virtual void     UpdateRecord( const string& collection_name, uint id, const Document& doc ) = 0;
@@ -38,14 +65,23 @@ protected:
 
 public:
     virtual ~DataBase() = default;
-    virtual UIntVec GetAllIds( const string& collection_name ) = 0;
-    Document        Get( const string& collection_name, uint id );
+    UIntVec  GetAllIds( const string& collection_name );
+    Document Get( const string& collection_name, uint id );
 
     void StartChanges();
-    void Insert( const string& collection_name, uint id, const Document& doc );
-    void Update( const string& collection_name, uint id, const string& key, const Value& value );
+    void Insert( const string& collection_name, uint id, Document doc );
+    void Update( const string& collection_name, uint id, const string& key, Value value );
     void Delete( const string& collection_name, uint id );
     void CommitChanges();
+
+    // Commit changes in separate thread, caller blocks when queue is full
+    void StartWriteBehind( uint max_queue_size );
+    void StopWriteBehind();
+    void FlushWrites();
+    uint   GetWriteQueueSize();
+    uint   GetWriteQueuePeak() { return writeQueuePeak; }
+    double GetCommitTime()     { return commitTime; }
+    double GetCommitTimeMax()  { return commitTimeMax; }
 };
 
 extern DataBase* DbStorage;
@@ -12,7 +12,8 @@ EntityManager EntityMngr;
 
 EntityManager::EntityManager()
 {
-    memzero( entitiesCount, sizeof( entitiesCount ) );
+    changesFlushing = false;
+    PropertiesCoalescing = false;
 }
 
 void EntityManager::RegisterEntity( Entity* entity )
@@ -29,30 +30,60 @@ void EntityManager::RegisterEntity( Entity* entity )
         doc[ "_Proto" ] = entity->Proto ? entity->Proto->GetName() : "";
 
         if( entity->Type == EntityType::Location )
-            DbStorage->Insert( "Locations", id, doc );
+            DbStorage->Insert( "Locations", id, std::move( doc ) );
         else if( entity->Type == EntityType::Map )
-            DbStorage->Insert( "Maps", id, doc );
+            DbStorage->Insert( "Maps", id, std::move( doc ) );
         else if( entity->Type == EntityType::Npc )
-            DbStorage->Insert( "Critters", id, doc );
+            DbStorage->Insert( "Critters", id, std::move( doc ) );
         else if( entity->Type == EntityType::Item )
-            DbStorage->Insert( "Items", id, doc );
+            DbStorage->Insert( "Items", id, std::move( doc ) );
         else if( entity->Type == EntityType::Custom )
-            DbStorage->Insert( entity->Props.GetRegistrator()->GetClassName() + "s", id, doc );
+            DbStorage->Insert( entity->Props.GetRegistrator()->GetClassName() + "s", id, std::move( doc ) );
         else
             RUNTIME_ASSERT( !"Unreachable place" );
     }
 
     auto it = allEntities.insert( std::make_pair( entity->Id, entity ) );
     RUNTIME_ASSERT( it.second );
-    entitiesCount[ (int) entity->Type ]++;
+    entitiesByType[ (int) entity->Type ].insert( std::make_pair( entity->Id, entity ) );
+
+    if( entity->Type == EntityType::Map )
+        mapsByPid[ entity->GetProtoId() ].insert( std::make_pair( entity->Id, entity ) );
+    else if( entity->Type == EntityType::Location )
+        locationsByPid[ entity->GetProtoId() ].insert( std::make_pair( entity->Id, entity ) );
+    else if( entity->Type == EntityType::Item && ( (Item*) entity )->GetAccessory() == ITEM_ACCESSORY_CRITTER )
+        AddCritterItem( ( (Item*) entity )->GetCritId(), (Item*) entity );
 }
 
 void EntityManager::UnregisterEntity( Entity* entity )
 {
+    // Store pending time events while entity still have id
+    if( entity->Type == EntityType::Npc || entity->Type == EntityType::Client )
+        ( (Critter*) entity )->FlushCrTimeEvents();
+
+    // And pending property changes
+    auto it_changed = changedEntitiesIndex.find( entity );
+    if( it_changed != changedEntitiesIndex.end() )
+    {
+        ChangedEntity& changed_entity = changedEntities[ it_changed->second ];
+        changedEntitiesIndex.erase( it_changed );
+        FlushChangedEntity( changed_entity );
+        changed_entity.Owner = nullptr;
+        changed_entity.Props.clear();
+        entity->Release();
+    }
+
     auto it = allEntities.find( entity->Id );
     RUNTIME_ASSERT( it != allEntities.end() );
     allEntities.erase( it );
-    entitiesCount[ (int) entity->Type ]--;
+    entitiesByType[ (int) entity->Type ].erase( entity->Id );
+
+    if( entity->Type == EntityType::Map )
+        EraseFromPidIndex( mapsByPid, entity );
+    else if( entity->Type == EntityType::Location )
+        EraseFromPidIndex( locationsByPid, entity );
+    else if( entity->Type == EntityType::Item )
+        EraseCritterItem( ( (Item*) entity )->GetCritId(), (Item*) entity );
 
     Script::RemoveEventsEntity( entity );
 
@@ -80,34 +111,36 @@ Entity* EntityManager::GetEntity( uint id, EntityType type )
 
 void EntityManager::GetEntities( EntityType type, EntityVec& entities )
 {
-    entities.reserve( entities.size() + entitiesCount[ (int) type ] );
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == type )
-            entities.push_back( it->second );
-    }
+    EntityMap& type_entities = entitiesByType[ (int) type ];
+    entities.reserve( entities.size() + type_entities.size() );
+    for( auto it = type_entities.begin(); it != type_entities.end(); ++it )
+        entities.push_back( it->second );
 }
 
 uint EntityManager::GetEntitiesCount( EntityType type )
 {
-    return entitiesCount[ (int) type ];
+    return (uint) entitiesByType[ (int) type ].size();
 }
 
 void EntityManager::GetItems( ItemVec& items )
 {
-    items.reserve( items.size() + entitiesCount[ (int) EntityType::Item ] );
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == EntityType::Item )
-            items.push_back( (Item*) it->second );
-    }
+    EntityMap& type_entities = entitiesByType[ (int) EntityType::Item ];
+    items.reserve( items.size() + type_entities.size() );
+    for( auto it = type_entities.begin(); it != type_entities.end(); ++it )
+        items.push_back( (Item*) it->second );
 }
 
 void EntityManager::GetCritterItems( uint crid, ItemVec& items )
 {
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
+    auto it_cr = critterItemIds.find( crid );
+    if( it_cr == critterItemIds.end() )
+        return;
+
+    EntityMap& type_entities = entitiesByType[ (int) EntityType::Item ];
+    for( uint item_id : it_cr->second )
     {
-        if( it->second->Type == EntityType::Item )
+        auto it = type_entities.find( item_id );
+        if( it != type_entities.end() )
         {
             Item* item = (Item*) it->second;
             if( item->GetAccessory() == ITEM_ACCESSORY_CRITTER && item->GetCritId() == crid )
@@ -116,6 +149,31 @@ void EntityManager::GetCritterItems( uint crid, ItemVec& items )
     }
 }
 
+void EntityManager::AddCritterItem( uint crid, Item* item )
+{
+    if( crid && item->Id )
+    {
+        UIntVec& ids = critterItemIds[ crid ];
+        auto     it = std::lower_bound( ids.begin(), ids.end(), item->Id );
+        if( it == ids.end() || *it != item->Id )
+            ids.insert( it, item->Id );
+    }
+}
+
+void EntityManager::EraseCritterItem( uint crid, Item* item )
+{
+    auto it = critterItemIds.find( crid );
+    if( it != critterItemIds.end() )
+    {
+        UIntVec& ids = it->second;
+        auto     it_id = std::lower_bound( ids.begin(), ids.end(), item->Id );
+        if( it_id != ids.end() && *it_id == item->Id )
+            ids.erase( it_id );
+        if( ids.empty() )
+            critterItemIds.erase( it );
+    }
+}
+
 Critter* EntityManager::GetCritter( uint id )
 {
     auto it = allEntities.find( id );
@@ -126,70 +184,67 @@ Critter* EntityManager::GetCritter( uint id )
 
 void EntityManager::GetCritters( CritterVec& critters )
 {
-    critters.reserve( critters.size() + entitiesCount[ (int) EntityType::Npc ] + entitiesCount[ (int) EntityType::Client ] );
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
+    EntityMap& npcs = entitiesByType[ (int) EntityType::Npc ];
+    EntityMap& clients = entitiesByType[ (int) EntityType::Client ];
+    critters.reserve( critters.size() + npcs.size() + clients.size() );
+
+    // Merge both id ordered maps, to keep global id order of all critters
+    auto it_npc = npcs.begin();
+    auto it_cl = clients.begin();
+    while( it_npc != npcs.end() || it_cl != clients.end() )
     {
-        if( it->second->Type == EntityType::Npc || it->second->Type == EntityType::Client )
-            critters.push_back( (Critter*) it->second );
+        if( it_cl == clients.end() || ( it_npc != npcs.end() && it_npc->first < it_cl->first ) )
+            critters.push_back( (Critter*) ( it_npc++ )->second );
+        else
+            critters.push_back( (Critter*) ( it_cl++ )->second );
     }
 }
 
 Map* EntityManager::GetMapByPid( hash pid, uint skip_count )
 {
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == EntityType::Map )
-        {
-            Map* map = (Map*) it->second;
-            if( map->GetProtoId() == pid )
-            {
-                if( !skip_count )
-                    return map;
-                else
-                    skip_count--;
-            }
-        }
-    }
-    return nullptr;
+    auto it_pid = mapsByPid.find( pid );
+    if( it_pid == mapsByPid.end() || skip_count >= it_pid->second.size() )
+        return nullptr;
+
+    auto it = it_pid->second.begin();
+    std::advance( it, skip_count );
+    return (Map*) it->second;
 }
 
 void EntityManager::GetMaps( MapVec& maps )
 {
-    maps.reserve( maps.size() + entitiesCount[ (int) EntityType::Map ] );
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == EntityType::Map )
-            maps.push_back( (Map*) it->second );
-    }
+    EntityMap& type_entities = entitiesByType[ (int) EntityType::Map ];
+    maps.reserve( maps.size() + type_entities.size() );
+    for( auto it = type_entities.begin(); it != type_entities.end(); ++it )
+        maps.push_back( (Map*) it->second );
 }
 
 Location* EntityManager::GetLocationByPid( hash pid, uint skip_count )
 {
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == EntityType::Location )
-        {
-            Location* loc = (Location*) it->second;
-            if( loc->GetProtoId() == pid )
-            {
-                if( !skip_count )
-                    return loc;
-                else
-                    skip_count--;
-            }
-        }
-    }
-    return nullptr;
+    auto it_pid = locationsByPid.find( pid );
+    if( it_pid == locationsByPid.end() || skip_count >= it_pid->second.size() )
+        return nullptr;
+
+    auto it = it_pid->second.begin();
+    std::advance( it, skip_count );
+    return (Location*) it->second;
 }
 
 void EntityManager::GetLocations( LocationVec& locs )
 {
-    locs.reserve( locs.size() + entitiesCount[ (int) EntityType::Location ] );
-    for( auto it = allEntities.begin(); it != allEntities.end(); ++it )
-    {
-        if( it->second->Type == EntityType::Location )
-            locs.push_back( (Location*) it->second );
-    }
+    EntityMap& type_entities = entitiesByType[ (int) EntityType::Location ];
+    locs.reserve( locs.size() + type_entities.size() );
+    for( auto it = type_entities.begin(); it != type_entities.end(); ++it )
+        locs.push_back( (Location*) it->second );
+}
+
+void EntityManager::EraseFromPidIndex( map< hash, EntityMap >& index, Entity* entity )
+{
+    auto it = index.find( entity->GetProtoId() );
+    RUNTIME_ASSERT( it != index.end() );
+    it->second.erase( entity->Id );
+    if( it->second.empty() )
+        index.erase( it );
 }
 
 bool EntityManager::LoadEntities()
@@ -558,11 +613,87 @@ void EntityManager::ClearEntities()
     {
         it->second->IsDestroyed = true;
         Script::RemoveEventsEntity( it->second );
-        entitiesCount[ (int) it->second->Type ]--;
         SAFEREL( it->second );
     }
     allEntities.clear();
 
     for( int i = 0; i < (int) EntityType::Max; i++ )
-        RUNTIME_ASSERT( entitiesCount[ i ] == 0 );
+        entitiesByType[ i ].clear();
+    mapsByPid.clear();
+    locationsByPid.clear();
+    critterItemIds.clear();
+}
+
+EntityManager::ChangedProperty& EntityManager::AddChangedProperty( Entity* entity, Property* prop )
+{
+    auto it = changedEntitiesIndex.find( entity );
+    if( it == changedEntitiesIndex.end() )
+    {
+        it = changedEntitiesIndex.insert( std::make_pair( entity, (uint) changedEntities.size() ) ).first;
+        changedEntities.push_back( ChangedEntity() );
+        changedEntities.back().Owner = entity;
+        entity->AddRef();
+    }
+
+    ChangedEntity& changed_entity = changedEntities[ it->second ];
+    for( ChangedProperty& changed_prop : changed_entity.Props )
+        if( changed_prop.Prop == prop )
+            return changed_prop;
+
+    ChangedProperty changed_prop;
+    changed_prop.Prop = prop;
+    changed_prop.SendCallback = nullptr;
+    changed_prop.StoreCallback = nullptr;
+    changed_entity.Props.push_back( changed_prop );
+    return changed_entity.Props.back();
+}
+
+bool EntityManager::DeferPropertySend( Entity* entity, Property* prop, NativeSendCallback callback )
+{
+    if( !PropertiesCoalescing || changesFlushing )
+        return false;
+
+    AddChangedProperty( entity, prop ).SendCallback = callback;
+    return true;
+}
+
+bool EntityManager::DeferPropertyStore( Entity* entity, Property* prop, NativeCallback callback )
+{
+    if( !PropertiesCoalescing || changesFlushing )
+        return false;
+
+    AddChangedProperty( entity, prop ).StoreCallback = callback;
+    return true;
+}
+
+void EntityManager::FlushChangedEntity( ChangedEntity& changed_entity )
+{
+    // Current values used, so each property stored and sent once with latest value
+    // Sends of one entity go together and leave in same network frame
+    RUNTIME_ASSERT( !changesFlushing );
+    changesFlushing = true;
+    for( ChangedProperty& changed_prop : changed_entity.Props )
+        if( changed_prop.StoreCallback )
+            changed_prop.StoreCallback( changed_entity.Owner, changed_prop.Prop, nullptr, nullptr );
+    for( ChangedProperty& changed_prop : changed_entity.Props )
+        if( changed_prop.SendCallback )
+            changed_prop.SendCallback( changed_entity.Owner, changed_prop.Prop );
+    changesFlushing = false;
+}
+
+void EntityManager::FlushChangedProperties()
+{
+    vector< ChangedEntity > changed_entities;
+    changed_entities.swap( changedEntities );
+    changedEntitiesIndex.clear();
+
+    for( ChangedEntity& changed_entity : changed_entities )
+    {
+        if( !changed_entity.Owner )
+            continue;
+
+        if( !changed_entity.Owner->IsDestroyed )
+            FlushChangedEntity( changed_entity );
+        changed_entity.Owner->Release();
+    }
 }
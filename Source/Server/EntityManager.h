@@ -10,9 +10,32 @@
 class EntityManager
 {
 private:
-    EntityMap allEntities;
-    uint      entitiesCount[ (int) EntityType::Max ];
+    EntityMap                allEntities;
+    EntityMap                entitiesByType[ (int) EntityType::Max ];
+    map< hash, EntityMap >   mapsByPid;
+    map< hash, EntityMap >   locationsByPid;
+    map< uint, UIntVec >     critterItemIds; // Sorted candidates, actual owner checked on query
 
+    // Property changes deferred to end of cycle, latest value sent and stored once
+    struct ChangedProperty
+    {
+        Property*          Prop;
+        NativeSendCallback SendCallback;
+        NativeCallback     StoreCallback;
+    };
+    struct ChangedEntity
+    {
+        Entity*                   Owner;
+        vector< ChangedProperty > Props;
+    };
+    vector< ChangedEntity > changedEntities;
+    map< Entity*, uint >    changedEntitiesIndex;
+    bool                    changesFlushing;
+
+    ChangedProperty& AddChangedProperty( Entity* entity, Property* prop );
+    void             FlushChangedEntity( ChangedEntity& changed_entity );
+
+    void EraseFromPidIndex( map< hash, EntityMap >& index, Entity* entity );
     bool LinkMaps();
     bool LinkNpc();
     bool LinkItems();
@@ -29,6 +52,8 @@ public:
 
     void      GetItems( ItemVec& items );
     void      GetCritterItems( uint crid, ItemVec& items );
+    void      AddCritterItem( uint crid, Item* item );
+    void      EraseCritterItem( uint crid, Item* item );
     Critter*  GetCritter( uint crid );
     void      GetCritters( CritterVec& critters );
     Map*      GetMapByPid( hash pid, uint skip_count );
@@ -38,6 +63,12 @@ public:
 
     bool LoadEntities();
     void ClearEntities();
+
+    // Property changes coalescing
+    bool PropertiesCoalescing;
+    bool DeferPropertySend( Entity* entity, Property* prop, NativeSendCallback callback );
+    bool DeferPropertyStore( Entity* entity, Property* prop, NativeCallback callback );
+    void FlushChangedProperties();
 };
 
 extern EntityManager EntityMngr;
@@ -46,6 +46,13 @@ Map::Map( uint id, ProtoMap* proto, Location* location ): Entity( id, EntityType
     hexFlagsSize = GetWidth() * GetHeight();
     hexFlags = new uchar[ hexFlagsSize ];
     memzero( hexFlags, hexFlagsSize );
+
+    crittersGrid.Init( GetWidth(), GetHeight() );
+    itemsGrid.Init( GetWidth(), GetHeight() );
+    crittersMaxMultihex = 0;
+    crittersLookRadius = 0;
+    ProcessTime = 0.0;
+    ProcessTimeMax = 0.0;
 }
 
 Map::~Map()
@@ -76,6 +83,7 @@ void Map::DeleteContent()
     RUNTIME_ASSERT( mapItemsById.empty() );
     RUNTIME_ASSERT( mapItemsByHex.empty() );
     RUNTIME_ASSERT( mapBlockLinesByHex.empty() );
+    RUNTIME_ASSERT( mapItemsByPid.empty() );
 }
 
 bool Map::Generate()
@@ -264,6 +272,8 @@ void Map::AddCritter( Critter* cr )
     if( cr->IsNpc() )
         mapNpcs.push_back( (Npc*) cr );
     mapCritters.push_back( cr );
+    crittersGrid.Add( cr, cr->GetHexX(), cr->GetHexY() );
+    crittersMaxMultihex = MAX( crittersMaxMultihex, cr->GetMultihex() );
 
     SetFlagCritter( cr->GetHexX(), cr->GetHexY(), cr->GetMultihex(), cr->IsDead() );
 
@@ -289,12 +299,29 @@ void Map::EraseCritter( Critter* cr )
     auto it = std::find( mapCritters.begin(), mapCritters.end(), cr );
     RUNTIME_ASSERT( it != mapCritters.end() );
     mapCritters.erase( it );
+    crittersGrid.Remove( cr, cr->GetHexX(), cr->GetHexY() );
 
     cr->SetTimeoutBattle( 0 );
 
     MapMngr.RunGarbager();
 }
 
+void Map::MoveCritterCell( Critter* cr, ushort from_hx, ushort from_hy )
+{
+    crittersGrid.Move( cr, from_hx, from_hy, cr->GetHexX(), cr->GetHexY() );
+}
+
+void Map::RefreshCrittersLookRadius()
+{
+    uint radius = GameOpt.LookMinimum;
+    for( Critter* cr : mapCritters )
+    {
+        radius = MAX( radius, (uint) MAX( (int) cr->GetLookDistance(), 0 ) );
+        radius = MAX( radius, MAX( cr->GetShowCritterDist1(), MAX( cr->GetShowCritterDist2(), cr->GetShowCritterDist3() ) ) );
+    }
+    crittersLookRadius = radius;
+}
+
 void Map::KickPlayersToGlobalMap()
 {
     for( Client* player : GetPlayers() )
@@ -358,6 +385,8 @@ void Map::SetItem( Item* item, ushort hx, ushort hy )
     mapItems.push_back( item );
     mapItemsById.insert( std::make_pair( item->GetId(), item ) );
     mapItemsByHex.insert( std::make_pair( ( hy << 16 ) | hx, ItemVec() ) ).first->second.push_back( item );
+    mapItemsByPid.insert( std::make_pair( item->GetProtoId(), ItemVec() ) ).first->second.push_back( item );
+    itemsGrid.Add( item, hx, hy );
 
     if( item->GetIsGeck() )
         mapLocation->GeckCount++;
@@ -390,6 +419,16 @@ void Map::EraseItem( uint item_id )
     if( it_hex_all->second.empty() )
         mapItemsByHex.erase( it_hex_all );
 
+    auto it_pid_all = mapItemsByPid.find( item->GetProtoId() );
+    RUNTIME_ASSERT( it_pid_all != mapItemsByPid.end() );
+    auto it_pid = std::find( it_pid_all->second.begin(), it_pid_all->second.end(), item );
+    RUNTIME_ASSERT( it_pid != it_pid_all->second.end() );
+    it_pid_all->second.erase( it_pid );
+    if( it_pid_all->second.empty() )
+        mapItemsByPid.erase( it_pid_all );
+
+    itemsGrid.Remove( item, hx, hy );
+
     item->SetAccessory( ITEM_ACCESSORY_NONE );
     item->SetMapId( 0 );
     item->SetHexX( 0 );
@@ -420,21 +459,27 @@ void Map::SendProperty( NetProperty::Type type, Property* prop, Entity* entity )
 {
     if( type == NetProperty::MapItem )
     {
-        Item* item = (Item*) entity;
+        Item*    item = (Item*) entity;
+        NetFrame frame;
         for( Critter* cr : GetCritters() )
         {
             if( cr->CountIdVisItem( item->GetId() ) )
             {
-                cr->Send_Property( type, prop, entity );
+                if( cr->IsPlayer() && frame.IsEmpty() )
+                    Client::MakePropertyFrame( frame, type, prop, entity );
+                cr->Send_Frame( frame );
                 Script::RaiseInternalEvent( ServerFunctions.CritterChangeItemOnMap, cr, item );
             }
         }
     }
     else if( type == NetProperty::Map || type == NetProperty::Location )
     {
+        NetFrame frame;
         for( Critter* cr : GetCritters() )
         {
-            cr->Send_Property( type, prop, entity );
+            if( cr->IsPlayer() && frame.IsEmpty() )
+                Client::MakePropertyFrame( frame, type, prop, entity );
+            cr->Send_Frame( frame );
             if( type == NetProperty::Map && ( prop == Map::PropertyDayTime || prop == Map::PropertyDayColor ) )
                 cr->Send_GameInfo( nullptr );
         }
@@ -556,16 +601,23 @@ void Map::GetItemsHex( ushort hx, ushort hy, ItemVec& items )
 
 void Map::GetItemsHexEx( ushort hx, ushort hy, uint radius, hash pid, ItemVec& items )
 {
-    for( Item* item : mapItems )
-        if( ( !pid || item->GetProtoId() == pid ) && DistGame( item->GetHexX(), item->GetHexY(), hx, hy ) <= radius )
-            items.push_back( item );
+    itemsGrid.Collect( hx, hy, radius, items, [ pid, hx, hy, radius ] ( Item * item )
+                       {
+                           return ( !pid || item->GetProtoId() == pid ) && DistGame( item->GetHexX(), item->GetHexY(), hx, hy ) <= radius;
+                       } );
 }
 
 void Map::GetItemsPid( hash pid, ItemVec& items )
 {
-    for( Item* item : mapItems )
-        if( !pid || item->GetProtoId() == pid )
-            items.push_back( item );
+    if( !pid )
+    {
+        items.insert( items.end(), mapItems.begin(), mapItems.end() );
+        return;
+    }
+
+    auto it_pid_all = mapItemsByPid.find( pid );
+    if( it_pid_all != mapItemsByPid.end() )
+        items.insert( items.end(), it_pid_all->second.begin(), it_pid_all->second.end() );
 }
 
 void Map::GetItemsTrigger( ushort hx, ushort hy, ItemVec& traps )
@@ -813,12 +865,13 @@ void Map::UnsetFlagCritter( ushort hx, ushort hy, uint multihex, bool dead )
 {
     if( dead )
     {
-        uint dead_count = 0;
-        for( Critter* cr : mapCritters )
-            if( cr->GetHexX() == hx && cr->GetHexY() == hy && cr->IsDead() )
-                dead_count++;
+        CritterVec dead_critters;
+        crittersGrid.Collect( hx, hy, 0, dead_critters, [ hx, hy ] ( Critter * cr )
+                              {
+                                  return cr->GetHexX() == hx && cr->GetHexY() == hy && cr->IsDead();
+                              } );
 
-        if( dead_count <= 1 )
+        if( dead_critters.size() <= 1 )
             UnsetHexFlag( hx, hy, FH_DEAD_CRITTER );
     }
     else
@@ -880,35 +933,26 @@ Critter* Map::GetHexCritter( ushort hx, ushort hy, bool dead )
     if( !IsFlagCritter( hx, hy, dead ) )
         return nullptr;
 
-    for( Critter* cr : mapCritters )
-    {
-        if( cr->IsDead() == dead )
-        {
-            int mh = cr->GetMultihex();
-            if( !mh )
-            {
-                if( cr->GetHexX() == hx && cr->GetHexY() == hy )
-                    return cr;
-            }
-            else
-            {
-                if( CheckDist( cr->GetHexX(), cr->GetHexY(), hx, hy, mh ) )
-                    return cr;
-            }
-        }
-    }
-    return nullptr;
+    CritterVec hex_critters;
+    crittersGrid.Collect( hx, hy, crittersMaxMultihex, hex_critters, [ hx, hy, dead ] ( Critter * cr )
+                          {
+                              if( cr->IsDead() != dead )
+                                  return false;
+                              int mh = cr->GetMultihex();
+                              if( !mh )
+                                  return cr->GetHexX() == hx && cr->GetHexY() == hy;
+                              return CheckDist( cr->GetHexX(), cr->GetHexY(), hx, hy, mh );
+                          } );
+    return !hex_critters.empty() ? hex_critters.front() : nullptr;
 }
 
 void Map::GetCrittersHex( ushort hx, ushort hy, uint radius, int find_type, CritterVec& critters )
 {
     CritterVec find_critters;
-    find_critters.reserve( mapCritters.size() );
-    for( Critter* cr : mapCritters )
-    {
-        if( cr->CheckFind( find_type ) && CheckDist( hx, hy, cr->GetHexX(), cr->GetHexY(), radius + cr->GetMultihex() ) )
-            find_critters.push_back( cr );
-    }
+    crittersGrid.Collect( hx, hy, radius + crittersMaxMultihex, find_critters, [ hx, hy, radius, find_type ] ( Critter * cr )
+                          {
+                              return cr->CheckFind( find_type ) && CheckDist( hx, hy, cr->GetHexX(), cr->GetHexY(), radius + cr->GetMultihex() );
+                          } );
 
     // Store result, append
     if( !find_critters.empty() )
@@ -5,6 +5,7 @@
 #include "Item.h"
 #include "Critter.h"
 #include "Entity.h"
+#include "SpatialGrid.h"
 
 class Map;
 class Location;
@@ -37,6 +38,10 @@ public:
     Map( uint id, ProtoMap* proto, Location* location );
     ~Map();
 
+    // Map tick time, in milliseconds
+    double ProcessTime;
+    double ProcessTimeMax;
+
 private:
     uchar*     hexFlags;
     int        hexFlagsSize;
@@ -47,9 +52,15 @@ private:
     ItemMap    mapItemsById;
     ItemVecMap mapItemsByHex;
     ItemVecMap mapBlockLinesByHex;
+    ItemVecMap mapItemsByPid;
     Location*  mapLocation;
     uint       loopLastTick[ 5 ];
 
+    HexSpatialGrid< Critter > crittersGrid;
+    HexSpatialGrid< Item >    itemsGrid;
+    uint                      crittersMaxMultihex;
+    uint                      crittersLookRadius;
+
     void PlaceItemBlocks( ushort hx, ushort hy, Item* item );
     void RemoveItemBlocks( ushort hx, ushort hy, Item* item );
 
@@ -71,6 +82,7 @@ public:
 
     void AddCritter( Critter* cr );
     void EraseCritter( Critter* cr );
+    void MoveCritterCell( Critter* cr, ushort from_hx, ushort from_hy );
     void KickPlayersToGlobalMap();
 
     bool AddItem( Item* item, ushort hx, ushort hy );
@@ -124,6 +136,11 @@ public:
     uint        GetPlayersCount()  { return (uint) mapPlayers.size(); }
     uint        GetNpcsCount()     { return (uint) mapNpcs.size(); }
 
+    // Upper bound of look and show distances of critters on map
+    uint GetCrittersLookRadius() { return crittersLookRadius; }
+    void UpdateCrittersLookRadius( uint radius ) { crittersLookRadius = MAX( crittersLookRadius, radius ); }
+    void RefreshCrittersLookRadius();
+
     // Sends
     void SendEffect( hash eff_pid, ushort hx, ushort hy, ushort radius );
     void SendFlyEffect( hash eff_pid, uint from_crid, uint to_crid, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy );
@@ -15,6 +15,7 @@ MapManager::MapManager(): runGarbager( true )
 {
     MEMORY_PROCESS( MEMORY_STATIC, sizeof( MapManager ) );
     MEMORY_PROCESS( MEMORY_STATIC, ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) ); // Grid, see below
+    MEMORY_PROCESS( MEMORY_STATIC, ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) * sizeof( uint ) ); // Grid generations
 
     pathNumCur = 0;
     for( int i = 1; i < FPATH_DATA_SIZE; i++ )
@@ -56,7 +57,7 @@ string MapManager::GetLocationsMapsStatistics()
     string result = _str( "Locations count: {}\n", (uint) locations.size() );
     result += _str( "Maps count: {}\n", (uint) maps.size() );
     result += "Location             Id           X     Y     Radius Color    Hidden  GeckVisible GeckCount AutoGarbage ToGarbage\n";
-    result += "          Map                 Id          Time Rain Script\n";
+    result += "          Map                 Id          Time Rain Tick     TickMax  Script\n";
     for( auto it = locations.begin(), end = locations.end(); it != end; ++it )
     {
         Location* loc = (Location*) *it;
@@ -67,8 +68,8 @@ string MapManager::GetLocationsMapsStatistics()
         uint map_index = 0;
         for( Map* map : loc->GetMaps() )
         {
-            result += _str( "     {:02}) {:<20} {:<9}   {:<4} {:<4} ",
-                            map_index, map->GetName(), map->GetId(), map->GetCurDayTime(), map->GetRainCapacity() );
+            result += _str( "     {:02}) {:<20} {:<9}   {:<4} {:<4} {:<8.3f} {:<8.3f} ",
+                            map_index, map->GetName(), map->GetId(), map->GetCurDayTime(), map->GetRainCapacity(), map->ProcessTime, map->ProcessTimeMax );
             result += map->GetScriptId() ? _str().parseHash( map->GetScriptId() ) : "";
             result += "\n";
             map_index++;
@@ -429,15 +430,120 @@ void MapManager::TraceBullet( TraceData& trace )
     }
 }
 
-int THREAD           MapGridOffsX = 0;
-int THREAD           MapGridOffsY = 0;
-static THREAD short* Grid = nullptr;
-#define GRID( x, y )    Grid[ ( ( FPATH_MAX_PATH + 1 ) + ( y ) - MapGridOffsY ) * ( FPATH_MAX_PATH * 2 + 2 ) + ( ( FPATH_MAX_PATH + 1 ) + ( x ) - MapGridOffsX ) ]
+struct PathOpenHex
+{
+    int    Index;
+    ushort HexX;
+    ushort HexY;
+};
+using PathOpenBuckets = vector< vector< PathOpenHex > >;
+
+int THREAD                     MapGridOffsX = 0;
+int THREAD                     MapGridOffsY = 0;
+static THREAD short*           Grid = nullptr;
+static THREAD uint*            GridGen = nullptr; // Cells with old generation treated as zero, instead of clearing whole grid
+static THREAD uint             GridCurGen = 0;
+static THREAD PathOpenBuckets* OpenBuckets = nullptr;
+
+static short& GridAt( int x, int y )
+{
+    uint index = ( ( FPATH_MAX_PATH + 1 ) + y - MapGridOffsY ) * ( FPATH_MAX_PATH * 2 + 2 ) + ( ( FPATH_MAX_PATH + 1 ) + x - MapGridOffsX );
+    if( GridGen[ index ] != GridCurGen )
+    {
+        GridGen[ index ] = GridCurGen;
+        Grid[ index ] = 0;
+    }
+    return Grid[ index ];
+}
+#define GRID( x, y )    GridAt( x, y )
+
+int MapManager::FindPathHeuristic( Map* map, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy, uint cut, ushort& hx, ushort& hy )
+{
+    // A* with game distance heuristic, explored hexes marked with wave indices, so path restored in same way as after wave
+    // Heuristic is consistent, therefore found index equal to wave index
+    // Estimates are small integers that never decrease while searching, so open hexes kept in buckets by estimate
+    // Estimate grows at most by two per index, this limits buckets count
+    if( !OpenBuckets )
+        OpenBuckets = new PathOpenBuckets( FPATH_MAX_PATH * 2 + 3 );
+
+    PathOpenBuckets& buckets = *OpenBuckets;
+    for( auto& bucket : buckets )
+        bucket.clear();
+
+    ushort maxhx = map->GetWidth();
+    ushort maxhy = map->GetHeight();
+    uint   dist = DistGame( from_hx, from_hy, to_hx, to_hy );
+    int    base_estimate = 1 + (int) ( dist > cut ? dist - cut : 0 );
+    uint   cur_bucket = 0;
+    buckets[ 0 ].push_back( { 1, from_hx, from_hy } );
+
+    bool too_far = false;
+    while( true )
+    {
+        while( cur_bucket < buckets.size() && buckets[ cur_bucket ].empty() )
+            cur_bucket++;
+        if( cur_bucket == buckets.size() )
+            break;
+
+        // Last added hexes usually deepest, take them first
+        PathOpenHex cur = buckets[ cur_bucket ].back();
+        buckets[ cur_bucket ].pop_back();
+
+        // Skip outdated entries
+        if( GRID( cur.HexX, cur.HexY ) != cur.Index )
+            continue;
+
+        if( CheckDist( cur.HexX, cur.HexY, to_hx, to_hy, cut ) )
+        {
+            hx = cur.HexX;
+            hy = cur.HexY;
+            return FPATH_OK;
+        }
+
+        int index = cur.Index + 1;
+        if( index > FPATH_MAX_PATH )
+        {
+            too_far = true;
+            continue;
+        }
+
+        short* sx, * sy;
+        GetHexOffsets( cur.HexX & 1, sx, sy );
+
+        for( int j = 0; j < DIRS_COUNT; j++ )
+        {
+            short nx = (short) cur.HexX + sx[ j ];
+            short ny = (short) cur.HexY + sy[ j ];
+            if( nx < 0 || ny < 0 || nx >= maxhx || ny >= maxhy )
+                continue;
+
+            short& g = GRID( nx, ny );
+            if( g == -1 || ( g > 0 && g <= index ) )
+                continue;
+
+            if( FLAG( map->GetHexFlags( nx, ny ), FH_NOWAY ) )
+            {
+                g = -1;
+                continue;
+            }
+
+            g = index;
+            dist = DistGame( nx, ny, to_hx, to_hy );
+            buckets[ index + (int) ( dist > cut ? dist - cut : 0 ) - base_estimate ].push_back( { index, (ushort) nx, (ushort) ny } );
+        }
+    }
+
+    return too_far ? FPATH_TOOFAR : FPATH_DEADLOCK;
+}
+
 int MapManager::FindPath( PathFindData& pfd )
 {
     // Allocate temporary grid
     if( !Grid )
+    {
         Grid = new short[ ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) ];
+        GridGen = new uint[ ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) ]();
+    }
 
     // Data
     uint   map_id = pfd.MapId;
@@ -515,7 +621,11 @@ int MapManager::FindPath( PathFindData& pfd )
 
     // Prepare
     int numindex = 1;
-    memzero( Grid, ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) * sizeof( short ) );
+    if( ++GridCurGen == 0 )
+    {
+        memzero( GridGen, ( FPATH_MAX_PATH * 2 + 2 ) * ( FPATH_MAX_PATH * 2 + 2 ) * sizeof( uint ) );
+        GridCurGen = 1;
+    }
     MapGridOffsX = from_hx;
     MapGridOffsY = from_hy;
     GRID( from_hx, from_hy ) = numindex;
@@ -531,6 +641,18 @@ int MapManager::FindPath( PathFindData& pfd )
     // Begin search
     int    p = 0, p_togo = 1;
     ushort cx, cy;
+
+    // Without critters, gags and multihex all hexes have equal cost, so heuristic search gives same path length
+    if( !multihex && !check_cr && !check_gag_items )
+    {
+        int result = FindPathHeuristic( map, from_hx, from_hy, to_hx, to_hy, cut, cx, cy );
+        if( result != FPATH_OK )
+            return result;
+
+        numindex = GRID( cx, cy );
+        goto label_FindOk;
+    }
+
     while( true )
     {
         for( int i = 0; i < p_togo; i++, p++ )
@@ -1230,9 +1352,12 @@ bool MapManager::Transit( Critter* cr, Map* map, ushort hx, ushort hy, uchar dir
         cr->LockMapTransfers++;
 
         cr->SetDir( dir >= DIRS_COUNT ? 0 : dir );
-        map->UnsetFlagCritter( cr->GetHexX(), cr->GetHexY(), multihex, cr->IsDead() );
+        ushort from_hx = cr->GetHexX();
+        ushort from_hy = cr->GetHexY();
+        map->UnsetFlagCritter( from_hx, from_hy, multihex, cr->IsDead() );
         cr->SetHexX( hx );
         cr->SetHexY( hy );
+        map->MoveCritterCell( cr, from_hx, from_hy );
         map->SetFlagCritter( hx, hy, multihex, cr->IsDead() );
         cr->SetBreakTime( 0 );
         cr->Send_CustomCommand( cr, OTHER_TELEPORT, ( cr->GetHexX() << 16 ) | ( cr->GetHexY() ) );
@@ -129,6 +129,7 @@ public:
     uint         GetMapsCount();
     void         TraceBullet( TraceData& trace );
     int          FindPath( PathFindData& pfd );
+    int          FindPathHeuristic( Map* map, ushort from_hx, ushort from_hy, ushort to_hx, ushort to_hy, uint cut, ushort& hx, ushort& hy );
     int          FindPathGrid( ushort& hx, ushort& hy, int index, bool smooth_switcher );
     PathStepVec& GetPath( uint num ) { return pathesPool[ num ]; }
     void         PathSetMoveParams( PathStepVec& path, bool is_run );
@@ -3,7 +3,9 @@
 #include "Exception.h"
 #include "Timer.h"
 #include "StringUtils.h"
+#include "NetCompression.h"
 #include <stdexcept>
+#include <atomic>
 
 #define ASIO_STANDALONE
 #include "asio.hpp"
@@ -29,64 +31,431 @@ static void  ZlibFree( void* opaque, void* address )                          {
 # define InterlockedExchange( val, newval )    __sync_lock_test_and_set( val, newval )
 #endif
 
+uint NetConnection::BatchSize = 0;
+int  NetConnection::CompressionLevel = Z_BEST_SPEED;
+bool NetConnection::CompressionAdaptive = false;
+
+NetMessagesStatistics NetConnection::SendStatistics;
+NetMessagesStatistics NetConnection::RecvStatistics;
+
 NetConnection::~NetConnection() {}
 
+void NetConnection::BeginMessage()
+{
+    Bout.Lock();
+    msgBeginPos = Bout.GetEndPos();
+    msgBeginKeyPos = Bout.GetEncryptKeyPos();
+    msgBeginTime = Timer::AccurateTick();
+}
+
+void NetConnection::EndMessage()
+{
+    uint msg = Bout.PeekUInt( msgBeginPos, msgBeginKeyPos );
+    uint bytes = Bout.GetEndPos() - msgBeginPos;
+    SendStatistics.Add( msg, bytes, Timer::AccurateTick() - msgBeginTime );
+    MessagesSend++;
+    BytesSend += bytes;
+    Bout.Unlock();
+
+    Dispatch();
+}
+
+void NetConnection::BeginProcessing( uint msg )
+{
+    processMsg = msg;
+    processBeginPos = Bin.GetCurPos() - sizeof( msg );
+    processBeginTime = Timer::AccurateTick();
+}
+
+void NetConnection::EndProcessing()
+{
+    // Not started or returned back to buffer
+    if( !processMsg )
+        return;
+
+    uint msg = processMsg;
+    processMsg = 0;
+    if( Bin.GetCurPos() <= processBeginPos + sizeof( msg ) )
+        return;
+
+    uint bytes = Bin.GetCurPos() - processBeginPos;
+    RecvStatistics.Add( msg, bytes, Timer::AccurateTick() - processBeginTime );
+    MessagesRecv++;
+    BytesRecv += bytes;
+}
+
+void NetMessagesStatistics::Clear()
+{
+    memzero( Count, sizeof( Count ) );
+    memzero( Bytes, sizeof( Bytes ) );
+    for( uint i = 0; i < MaxMessages; i++ )
+        Time[ i ] = 0.0;
+}
+
+void NetMessagesStatistics::Add( uint msg, uint bytes, double time )
+{
+    uint index = GetIndex( msg );
+    Count[ index ]++;
+    Bytes[ index ] += bytes;
+    Time[ index ] += time;
+}
+
+uint NetMessagesStatistics::GetIndex( uint msg )
+{
+    // Not a message header goes to zero index
+    if( ( msg & 0xFFFF00FF ) != MAKE_NETMSG_HEADER( 0 ) )
+        return 0;
+    return ( msg >> 8 ) & 0xFF;
+}
+
+const char* NetMessagesStatistics::GetName( uint index )
+{
+    static const char* names[ MaxMessages ];
+    if( !names[ 0 ] )
+    {
+        for( uint i = 0; i < MaxMessages; i++ )
+            names[ i ] = "NETMSG_UNKNOWN";
+
+        #define ADD_NAME( msg )    names[ GetIndex( msg ) ] = #msg
+        ADD_NAME( NETMSG_DISCONNECT );
+        ADD_NAME( NETMSG_LOGIN );
+        ADD_NAME( NETMSG_LOGIN_SUCCESS );
+        ADD_NAME( NETMSG_WRONG_NET_PROTO );
+        ADD_NAME( NETMSG_CREATE_CLIENT );
+        ADD_NAME( NETMSG_REGISTER_SUCCESS );
+        ADD_NAME( NETMSG_PING );
+        ADD_NAME( NETMSG_COMPRESSION );
+        ADD_NAME( NETMSG_END_PARSE_TO_GAME );
+        ADD_NAME( NETMSG_UPDATE );
+        ADD_NAME( NETMSG_UPDATE_FILES_LIST );
+        ADD_NAME( NETMSG_GET_UPDATE_FILE );
+        ADD_NAME( NETMSG_GET_UPDATE_FILE_DATA );
+        ADD_NAME( NETMSG_UPDATE_FILE_DATA );
+        ADD_NAME( NETMSG_GET_UPDATE_FILE_PART );
+        ADD_NAME( NETMSG_ADD_PLAYER );
+        ADD_NAME( NETMSG_ADD_NPC );
+        ADD_NAME( NETMSG_REMOVE_CRITTER );
+        ADD_NAME( NETMSG_SEND_COMMAND );
+        ADD_NAME( NETMSG_SEND_TEXT );
+        ADD_NAME( NETMSG_CRITTER_TEXT );
+        ADD_NAME( NETMSG_MSG );
+        ADD_NAME( NETMSG_MSG_LEX );
+        ADD_NAME( NETMSG_MAP_TEXT );
+        ADD_NAME( NETMSG_MAP_TEXT_MSG );
+        ADD_NAME( NETMSG_MAP_TEXT_MSG_LEX );
+        ADD_NAME( NETMSG_DIR );
+        ADD_NAME( NETMSG_CRITTER_DIR );
+        ADD_NAME( NETMSG_SEND_MOVE_WALK );
+        ADD_NAME( NETMSG_SEND_MOVE_RUN );
+        ADD_NAME( NETMSG_CRITTER_MOVE );
+        ADD_NAME( NETMSG_CRITTER_XY );
+        ADD_NAME( NETMSG_ALL_PROPERTIES );
+        ADD_NAME( NETMSG_CUSTOM_COMMAND );
+        ADD_NAME( NETMSG_CLEAR_ITEMS );
+        ADD_NAME( NETMSG_ADD_ITEM );
+        ADD_NAME( NETMSG_REMOVE_ITEM );
+        ADD_NAME( NETMSG_ALL_ITEMS_SEND );
+        ADD_NAME( NETMSG_ADD_ITEM_ON_MAP );
+        ADD_NAME( NETMSG_ERASE_ITEM_FROM_MAP );
+        ADD_NAME( NETMSG_ANIMATE_ITEM );
+        ADD_NAME( NETMSG_SOME_ITEMS );
+        ADD_NAME( NETMSG_SOME_ITEM );
+        ADD_NAME( NETMSG_CRITTER_ACTION );
+        ADD_NAME( NETMSG_CRITTER_MOVE_ITEM );
+        ADD_NAME( NETMSG_CRITTER_ANIMATE );
+        ADD_NAME( NETMSG_CRITTER_SET_ANIMS );
+        ADD_NAME( NETMSG_COMBAT_RESULTS );
+        ADD_NAME( NETMSG_EFFECT );
+        ADD_NAME( NETMSG_FLY_EFFECT );
+        ADD_NAME( NETMSG_PLAY_SOUND );
+        ADD_NAME( NETMSG_SEND_TALK_NPC );
+        ADD_NAME( NETMSG_TALK_NPC );
+        ADD_NAME( NETMSG_SEND_GET_INFO );
+        ADD_NAME( NETMSG_GAME_INFO );
+        ADD_NAME( NETMSG_LOADMAP );
+        ADD_NAME( NETMSG_MAP );
+        ADD_NAME( NETMSG_SEND_GIVE_MAP );
+        ADD_NAME( NETMSG_SEND_LOAD_MAP_OK );
+        ADD_NAME( NETMSG_RPC );
+        ADD_NAME( NETMSG_SEND_REFRESH_ME );
+        ADD_NAME( NETMSG_VIEW_MAP );
+        ADD_NAME( NETMSG_GLOBAL_INFO );
+        ADD_NAME( NETMSG_AUTOMAPS_INFO );
+        ADD_NAME( NETMSG_COMPLEX_PROPERTY );
+        ADD_NAME( NETMSG_SEND_COMPLEX_PROPERTY );
+        for( uint b = 1; b <= 8; b <<= 1 )
+        {
+            for( uint x = 0; x < 3; x++ )
+            {
+                ADD_NAME( NETMSG_POD_PROPERTY( b, x ) );
+                ADD_NAME( NETMSG_SEND_POD_PROPERTY( b, x ) );
+            }
+        }
+        #undef ADD_NAME
+    }
+    return names[ index ];
+}
+
+// Outgoing stream codec, one instance per connection
+class NetCompressor
+{
+public:
+    virtual ~NetCompressor() = default;
+
+    // Compress data to output buffer, returns size of written data, consumed input size in 'real'
+    virtual uint Compress( const uchar* data, uint len, UCharVec& out, uint& real ) = 0;
+
+    // Keep stream format but skip compression work, for already compressed data
+    virtual void SetStored( bool stored ) = 0;
+};
+
+// Zlib stream, every call ends with sync flush to allow decompression of received part
+// Adaptive mode stores data without compression for some calls if previous data was not compressible
+class NetZlibCompressor: public NetCompressor
+{
+    static const uint AdaptiveMinSize = 256;
+    static const uint AdaptiveStoreCalls = 32;
+
+    z_stream zStream;
+    int      level;
+    bool     adaptive;
+    uint     storeCalls;
+    bool     stored;
+
+public:
+    NetZlibCompressor( int level, bool adaptive ): level( level ), adaptive( adaptive ), storeCalls( 0 ), stored( false )
+    {
+        memzero( &zStream, sizeof( zStream ) );
+        zStream.zalloc = ZlibAlloc;
+        zStream.zfree = ZlibFree;
+        zStream.opaque = nullptr;
+        int result = deflateInit( &zStream, level );
+        RUNTIME_ASSERT( result == Z_OK );
+    }
+
+    virtual ~NetZlibCompressor() override
+    {
+        deflateEnd( &zStream );
+    }
+
+    virtual uint Compress( const uchar* data, uint len, UCharVec& out, uint& real ) override
+    {
+        out.resize( MAX( (uint) deflateBound( &zStream, len ) + 32, NetBuffer::DefaultBufSize ) );
+
+        zStream.next_in = (Bytef*) data;
+        zStream.avail_in = len;
+        zStream.next_out = &out[ 0 ];
+        zStream.avail_out = (uint) out.size();
+
+        int result = deflate( &zStream, Z_SYNC_FLUSH );
+        RUNTIME_ASSERT( result == Z_OK );
+
+        uint compr = (uint) ( (size_t) zStream.next_out - (size_t) &out[ 0 ] );
+        real = (uint) ( (size_t) zStream.next_in - (size_t) data );
+
+        if( adaptive && !stored )
+            Adapt( real, compr );
+        return compr;
+    }
+
+    virtual void SetStored( bool value ) override
+    {
+        if( stored == value )
+            return;
+
+        stored = value;
+        storeCalls = 0;
+        SetLevel( stored ? Z_NO_COMPRESSION : level );
+    }
+
+private:
+    void Adapt( uint real, uint compr )
+    {
+        // Level switch applied to next data, stream is already flushed
+        if( storeCalls )
+        {
+            if( --storeCalls == 0 )
+                SetLevel( level );
+        }
+        else if( real >= AdaptiveMinSize && compr >= real - real / 16 )
+        {
+            storeCalls = AdaptiveStoreCalls;
+            SetLevel( Z_NO_COMPRESSION );
+        }
+    }
+
+    void SetLevel( int new_level )
+    {
+        uchar dummy[ 64 ];
+        zStream.next_in = nullptr;
+        zStream.avail_in = 0;
+        zStream.next_out = dummy;
+        zStream.avail_out = sizeof( dummy );
+        int result = deflateParams( &zStream, new_level, Z_DEFAULT_STRATEGY );
+        RUNTIME_ASSERT( result == Z_OK );
+        RUNTIME_ASSERT( zStream.avail_out == sizeof( dummy ) );
+    }
+};
+
+// Fast LZ codec, only for clients which requested it before any other message
+class NetLzCompressor: public NetCompressor
+{
+    NetLzEncoder encoder;
+    bool         stored;
+
+public:
+    NetLzCompressor(): stored( false ) {}
+
+    virtual uint Compress( const uchar* data, uint len, UCharVec& out, uint& real ) override
+    {
+        // Whole data in one block
+        real = len;
+        return encoder.Compress( data, len, out, stored );
+    }
+
+    virtual void SetStored( bool value ) override
+    {
+        stored = value;
+    }
+};
+
 class NetConnectionImpl: public NetConnection
 {
-    z_stream* zStream;
-    uchar     outBuf[ NetBuffer::DefaultBufSize ];
+    NetCompressor*      compressor;
+    std::atomic< bool > compressionStored;
+    UCharVec            outBuf;
+    uint      pendingMessages;
+    uint      sendFrames;
+    uint      sendBytes;
+
+    // Received data, single network thread writes and logic thread reads without locking
+    // Positions are total counts of bytes, ring size is power of two
+    UCharVec            recvRing;
+    std::atomic< uint > recvWritePos;
+    std::atomic< uint > recvReadPos;
 
 public:
     NetConnectionImpl()
     {
         IsDisconnected = false;
         DisconnectTick = 0;
-        zStream = nullptr;
-        memzero( outBuf, sizeof( outBuf ) );
+        TickMessages = 0;
+        TickFrames = 0;
+        TickBytes = 0;
+        MessagesSend = 0;
+        BytesSend = 0;
+        MessagesRecv = 0;
+        BytesRecv = 0;
+        msgBeginPos = 0;
+        msgBeginKeyPos = 0;
+        msgBeginTime = 0.0;
+        processMsg = 0;
+        processBeginPos = 0;
+        processBeginTime = 0.0;
+        compressor = nullptr;
+        compressionStored = false;
+        pendingMessages = 0;
+        sendFrames = 0;
+        sendBytes = 0;
+
+        uint ring_size = NetBuffer::DefaultBufSize;
+        while( ring_size < GameOpt.FloodSize )
+            ring_size <<= 1;
+        recvRing.resize( ring_size );
+        recvWritePos = 0;
+        recvReadPos = 0;
 
         if( !GameOpt.DisableZlibCompression )
-        {
-            zStream = new z_stream();
-            zStream->zalloc = ZlibAlloc;
-            zStream->zfree = ZlibFree;
-            zStream->opaque = nullptr;
-            int result = deflateInit( zStream, Z_BEST_SPEED );
-            RUNTIME_ASSERT( result == Z_OK );
-        }
+            compressor = new NetZlibCompressor( CompressionLevel, CompressionAdaptive );
     }
 
     virtual ~NetConnectionImpl() override
     {
-        Dispatch();
+        Flush();
         Disconnect();
 
-        if( zStream )
-            deflateEnd( zStream );
-        SAFEDEL( zStream );
+        SAFEDEL( compressor );
     }
 
     virtual void DisableCompression() override
     {
-        if( zStream )
-            deflateEnd( zStream );
-        SAFEDEL( zStream );
+        SAFEDEL( compressor );
+    }
+
+    virtual bool SetCompression( uchar codec ) override
+    {
+        // Client switches decoder from its first received byte
+        Bout.Lock();
+        if( BytesSend )
+        {
+            Bout.Unlock();
+            return false;
+        }
+
+        SAFEDEL( compressor );
+        if( codec == NET_COMPRESSION_LZ )
+            compressor = new NetLzCompressor();
+        else if( codec == NET_COMPRESSION_ZLIB && !GameOpt.DisableZlibCompression )
+            compressor = new NetZlibCompressor( CompressionLevel, CompressionAdaptive );
+        Bout.Unlock();
+        return codec == NET_COMPRESSION_LZ || codec == NET_COMPRESSION_ZLIB;
+    }
+
+    virtual void SetCompressionStored( bool stored ) override
+    {
+        compressionStored = stored;
     }
 
     virtual void Dispatch() override
     {
-        if( IsDisconnected )
-            return;
+        pendingMessages++;
 
-        // Nothing to send
-        Bout.Lock();
-        if( Bout.IsEmpty() )
+        // Wait for flush at end of tick
+        if( BatchSize )
         {
+            Bout.Lock();
+            bool batch_full = ( Bout.GetEndPos() >= BatchSize );
             Bout.Unlock();
-            return;
+            if( !batch_full )
+                return;
         }
+
+        SendPending();
+    }
+
+    virtual void Flush() override
+    {
+        SendPending();
+
+        Bout.Lock();
+        TickMessages = pendingMessages;
+        TickFrames = sendFrames;
+        TickBytes = sendBytes;
+        pendingMessages = 0;
+        sendFrames = 0;
+        sendBytes = 0;
         Bout.Unlock();
+    }
 
-        DispatchImpl();
+    virtual void Receive() override
+    {
+        uint read_pos = recvReadPos.load( std::memory_order_relaxed );
+        uint write_pos = recvWritePos.load( std::memory_order_acquire );
+        if( read_pos == write_pos )
+            return;
+
+        uint mask = (uint) recvRing.size() - 1;
+        uint len = write_pos - read_pos;
+        uint offset = read_pos & mask;
+        uint first_len = MIN( len, (uint) recvRing.size() - offset );
+
+        Bin.Lock();
+        Bin.Push( &recvRing[ offset ], first_len, true );
+        if( first_len < len )
+            Bin.Push( &recvRing[ 0 ], len - first_len, true );
+        Bin.Unlock();
+
+        recvReadPos.store( write_pos, std::memory_order_release );
     }
 
     virtual void Disconnect() override
@@ -94,6 +463,10 @@ public:
         if( IsDisconnected )
             return;
 
+        // Last accumulated messages
+        if( BatchSize )
+            SendPending();
+
         IsDisconnected = true;
         if( !DisconnectTick )
             DisconnectTick = Timer::FastTick();
@@ -105,6 +478,23 @@ protected:
     virtual void DispatchImpl() = 0;
     virtual void DisconnectImpl() = 0;
 
+    void SendPending()
+    {
+        if( IsDisconnected )
+            return;
+
+        // Nothing to send
+        Bout.Lock();
+        if( Bout.IsEmpty() )
+        {
+            Bout.Unlock();
+            return;
+        }
+        Bout.Unlock();
+
+        DispatchImpl();
+    }
+
     const uchar* SendCallback( uint& out_len )
     {
         Bout.Lock();
@@ -114,37 +504,27 @@ protected:
             return nullptr;
         }
 
-        // Compress
-        if( zStream )
+        // Compress, whole accumulated data at once
+        if( compressor )
         {
-            uint to_compr = Bout.GetEndPos();
-            if( to_compr > sizeof( outBuf ) - 32 )
-                to_compr = sizeof( outBuf ) - 32;
-
-            zStream->next_in = Bout.GetCurData();
-            zStream->avail_in = to_compr;
-            zStream->next_out = outBuf;
-            zStream->avail_out = sizeof( outBuf );
-
-            int result = deflate( zStream, Z_SYNC_FLUSH );
-            RUNTIME_ASSERT( result == Z_OK );
-
-            uint compr = (uint) ( (size_t) zStream->next_out - (size_t) outBuf );
-            uint real = (uint) ( (size_t) zStream->next_in - (size_t) Bout.GetCurData() );
-            out_len = compr;
+            uint real = 0;
+            compressor->SetStored( compressionStored );
+            out_len = compressor->Compress( Bout.GetCurData(), Bout.GetEndPos(), outBuf, real );
             Bout.Cut( real );
         }
         // Without compressing
         else
         {
             uint len = Bout.GetEndPos();
-            if( len > sizeof( outBuf ) )
-                len = sizeof( outBuf );
-            memcpy( outBuf, Bout.GetCurData(), len );
+            outBuf.resize( MAX( len, NetBuffer::DefaultBufSize ) );
+            memcpy( &outBuf[ 0 ], Bout.GetCurData(), len );
             out_len = len;
             Bout.Cut( len );
         }
 
+        sendFrames++;
+        sendBytes += out_len;
+
         // Normalize buffer size
         if( Bout.IsEmpty() )
             Bout.Reset();
@@ -152,21 +532,30 @@ protected:
         Bout.Unlock();
 
         RUNTIME_ASSERT( out_len > 0 );
-        return outBuf;
+        return &outBuf[ 0 ];
     }
 
     void ReceiveCallback( const uchar* buf, uint len )
     {
-        Bin.Lock();
-        if( Bin.GetCurPos() + len >= GameOpt.FloodSize )
+        uint write_pos = recvWritePos.load( std::memory_order_relaxed );
+        uint read_pos = recvReadPos.load( std::memory_order_acquire );
+        uint pending = write_pos - read_pos;
+
+        // Flood, logic thread not takes data so fast
+        if( pending + len >= GameOpt.FloodSize || pending + len > (uint) recvRing.size() )
         {
-            Bin.Reset();
-            Bin.Unlock();
             Disconnect();
             return;
         }
-        Bin.Push( buf, len, true );
-        Bin.Unlock();
+
+        uint mask = (uint) recvRing.size() - 1;
+        uint offset = write_pos & mask;
+        uint first_len = MIN( len, (uint) recvRing.size() - offset );
+        memcpy( &recvRing[ offset ], buf, first_len );
+        if( first_len < len )
+            memcpy( &recvRing[ 0 ], buf + first_len, len - first_len );
+
+        recvWritePos.store( write_pos + len, std::memory_order_release );
     }
 };
 
@@ -201,12 +590,20 @@ class NetConnectionAsio: public NetConnectionImpl
         InterlockedExchange( &writePending, 0 );
 
         if( !error )
-            DispatchImpl();
+            WriteNext();
         else
             Disconnect();
     }
 
     virtual void DispatchImpl() override
+    {
+        // Compression and writing are done by network thread of this connection
+        // Running write picks up new data on completion
+        if( !writePending )
+            socket->get_io_service().post( std::bind( &NetConnectionAsio::WriteNext, this ) );
+    }
+
+    void WriteNext()
     {
         if( InterlockedExchange( &writePending, 1 ) == 0 )
         {
@@ -266,15 +663,29 @@ class NetTcpServer: public NetServerBase
     asio::ip::tcp::acceptor               acceptor;
     std::thread                           runThread;
 
-    void Run()
+    // Additional threads, each one with own service, connections are assigned in round robin order
+    // Handlers of one connection always run in one thread
+    vector< asio::io_service* >           workServices;
+    vector< asio::io_service::work* >     workGuards;
+    vector< std::thread >                 workThreads;
+    uint                                  nextService;
+
+    void Run( asio::io_service* service )
     {
         asio::error_code error;
-        ioService.run( error );
+        service->run( error );
     }
 
     void AcceptNext()
     {
-        asio::ip::tcp::socket* socket = new asio::ip::tcp::socket( ioService );
+        asio::io_service* service = &ioService;
+        if( !workServices.empty() )
+        {
+            service = workServices[ nextService % workServices.size() ];
+            nextService++;
+        }
+
+        asio::ip::tcp::socket* socket = new asio::ip::tcp::socket( *service );
         acceptor.async_accept( *socket,
                                std::bind( &NetTcpServer::AcceptConnection, this, std::placeholders::_1, socket ) );
     }
@@ -295,17 +706,41 @@ class NetTcpServer: public NetServerBase
     }
 
 public:
-    NetTcpServer( ushort port, std::function< void(NetConnection*) > callback ): acceptor( ioService, asio::ip::tcp::endpoint( asio::ip::tcp::v6(), port ) )
+    NetTcpServer( ushort port, uint threads, std::function< void(NetConnection*) > callback ): acceptor( ioService, asio::ip::tcp::endpoint( asio::ip::tcp::v6(), port ) )
     {
         connectionCallback = callback;
+        nextService = 0;
+
+        // Accepting thread also serves connections if pool is not used
+        if( threads > 1 )
+        {
+            for( uint i = 0; i < threads; i++ )
+            {
+                asio::io_service* service = new asio::io_service();
+                workServices.push_back( service );
+                workGuards.push_back( new asio::io_service::work( *service ) );
+            }
+            for( asio::io_service* service : workServices )
+                workThreads.push_back( std::thread( &NetTcpServer::Run, this, service ) );
+        }
+
         AcceptNext();
-        runThread = std::thread( &NetTcpServer::Run, this );
+        runThread = std::thread( &NetTcpServer::Run, this, &ioService );
     }
 
     virtual ~NetTcpServer() override
     {
         ioService.stop();
         runThread.join();
+
+        for( asio::io_service* service : workServices )
+            service->stop();
+        for( std::thread& thread : workThreads )
+            thread.join();
+        for( asio::io_service::work* work : workGuards )
+            delete work;
+        for( asio::io_service* service : workServices )
+            delete service;
     }
 };
 
@@ -387,7 +822,8 @@ class NetNoTlsWebSocketsServer: public NetServerBase
 {
     std::function< void(NetConnection*) > connectionCallback;
     web_sockets_no_tls                    server;
-    std::thread                           runThread;
+    vector< std::thread >                 runThreads;
+    Mutex                                 openLocker;
 
     void Run()
     {
@@ -396,6 +832,8 @@ class NetNoTlsWebSocketsServer: public NetServerBase
 
     void OnOpen( websocketpp::connection_hdl hdl )
     {
+        SCOPE_LOCK( openLocker );
+
         web_sockets_no_tls::connection_ptr connection = server.get_con_from_hdl( hdl );
         connectionCallback( new NetConnectionWS< web_sockets_no_tls >( &server, connection ) );
     }
@@ -409,7 +847,7 @@ class NetNoTlsWebSocketsServer: public NetServerBase
     }
 
 public:
-    NetNoTlsWebSocketsServer( ushort port, std::function< void(NetConnection*) > callback )
+    NetNoTlsWebSocketsServer( ushort port, uint threads, std::function< void(NetConnection*) > callback )
     {
         connectionCallback = callback;
 
@@ -419,13 +857,16 @@ public:
         server.listen( asio::ip::tcp::v6(), port );
         server.start_accept();
 
-        runThread = std::thread( &NetNoTlsWebSocketsServer::Run, this );
+        // Connection handlers are serialized by web sockets library strands
+        for( uint i = 0; i < MAX( threads, 1U ); i++ )
+            runThreads.push_back( std::thread( &NetNoTlsWebSocketsServer::Run, this ) );
     }
 
     virtual ~NetNoTlsWebSocketsServer() override
     {
         server.stop();
-        runThread.join();
+        for( std::thread& thread : runThreads )
+            thread.join();
     }
 };
 
@@ -433,7 +874,8 @@ class NetTlsWebSocketsServer: public NetServerBase
 {
     std::function< void(NetConnection*) > connectionCallback;
     web_sockets_tls                       server;
-    std::thread                           runThread;
+    vector< std::thread >                 runThreads;
+    Mutex                                 openLocker;
     string                                privateKey;
     string                                certificate;
 
@@ -444,6 +886,8 @@ class NetTlsWebSocketsServer: public NetServerBase
 
     void OnOpen( websocketpp::connection_hdl hdl )
     {
+        SCOPE_LOCK( openLocker );
+
         web_sockets_tls::connection_ptr connection = server.get_con_from_hdl( hdl );
         connectionCallback( new NetConnectionWS< web_sockets_tls >( &server, connection ) );
     }
@@ -466,7 +910,7 @@ class NetTlsWebSocketsServer: public NetServerBase
     }
 
 public:
-    NetTlsWebSocketsServer( ushort port, string private_key, string cert, std::function< void(NetConnection*) > callback )
+    NetTlsWebSocketsServer( ushort port, uint threads, string private_key, string cert, std::function< void(NetConnection*) > callback )
     {
         connectionCallback = callback;
         privateKey = private_key;
@@ -479,21 +923,24 @@ public:
         server.listen( asio::ip::tcp::v6(), port );
         server.start_accept();
 
-        runThread = std::thread( &NetTlsWebSocketsServer::Run, this );
+        // Connection handlers are serialized by web sockets library strands
+        for( uint i = 0; i < MAX( threads, 1U ); i++ )
+            runThreads.push_back( std::thread( &NetTlsWebSocketsServer::Run, this ) );
     }
 
     virtual ~NetTlsWebSocketsServer() override
     {
         server.stop();
-        runThread.join();
+        for( std::thread& thread : runThreads )
+            thread.join();
     }
 };
 
-NetServerBase* NetServerBase::StartTcpServer( ushort port, std::function< void(NetConnection*) > callback )
+NetServerBase* NetServerBase::StartTcpServer( ushort port, uint threads, std::function< void(NetConnection*) > callback )
 {
     try
     {
-        return new NetTcpServer( port, callback );
+        return new NetTcpServer( port, threads, callback );
     }
     catch( std::exception ex )
     {
@@ -502,20 +949,20 @@ NetServerBase* NetServerBase::StartTcpServer( ushort port, std::function< void(N
     }
 }
 
-NetServerBase* NetServerBase::StartWebSocketsServer( ushort port, string wss_credentials, std::function< void(NetConnection*) > callback )
+NetServerBase* NetServerBase::StartWebSocketsServer( ushort port, uint threads, string wss_credentials, std::function< void(NetConnection*) > callback )
 {
     try
     {
         if( wss_credentials.empty() )
         {
-            return new NetNoTlsWebSocketsServer( port, callback );
+            return new NetNoTlsWebSocketsServer( port, threads, callback );
         }
         else
         {
             StrVec keys = _str( wss_credentials ).split( ' ' );
             if( keys.size() != 2 ) throw std::runtime_error( "Invalid 'WssCredentials' option" );
 
-            return new NetTlsWebSocketsServer( port, keys[ 0 ], keys[ 1 ], callback );
+            return new NetTlsWebSocketsServer( port, threads, keys[ 0 ], keys[ 1 ], callback );
         }
     }
     catch( std::exception ex )
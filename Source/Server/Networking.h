@@ -5,6 +5,23 @@
 #include "NetBuffer.h"
 #include "zlib.h"
 
+// Traffic by message type, index is number from message header
+struct NetMessagesStatistics
+{
+    static const uint MaxMessages = 256;
+
+    int64  Count[ MaxMessages ];
+    int64  Bytes[ MaxMessages ];
+    double Time[ MaxMessages ]; // Writing of outgoing and processing of incoming messages, in milliseconds
+
+    NetMessagesStatistics() { Clear(); }
+    void Clear();
+    void Add( uint msg, uint bytes, double time );
+
+    static uint        GetIndex( uint msg );
+    static const char* GetName( uint index );
+};
+
 class NetConnection
 {
 public:
@@ -16,10 +33,52 @@ public:
     bool      IsDisconnected;
     uint      DisconnectTick;
 
+    // Statistics of last flushed tick
+    uint      TickMessages;
+    uint      TickFrames;
+    uint      TickBytes;
+
+    // Messages and not compressed bytes since connection
+    int64     MessagesSend;
+    int64     BytesSend;
+    int64     MessagesRecv;
+    int64     BytesRecv;
+
+    // Traffic of all connections
+    static NetMessagesStatistics SendStatistics;
+    static NetMessagesStatistics RecvStatistics;
+
+    // Accumulate messages until flush or until this size is reached, zero to send each message immediately
+    static uint BatchSize;
+
+    // Zlib level of outgoing stream and skipping of compression for not compressible data
+    static int  CompressionLevel;
+    static bool CompressionAdaptive;
+
     virtual ~NetConnection() = 0;
     virtual void DisableCompression() = 0;
-    virtual void Dispatch() = 0;
+    virtual bool SetCompression( uchar codec ) = 0; // Codec requested by client, allowed only before any sent data
+    virtual void SetCompressionStored( bool stored ) = 0; // Send following data as stored blocks
+    virtual void Dispatch() = 0; // Message complete
+    virtual void Flush() = 0;    // Send all accumulated messages
+    virtual void Receive() = 0;  // Move data received by network thread to Bin, call from logic thread
     virtual void Disconnect() = 0;
+
+    // Writing of outgoing message to Bout, locks buffer and dispatches message at end
+    void BeginMessage();
+    void EndMessage();
+
+    // Processing of incoming message which header already read from locked Bin
+    void BeginProcessing( uint msg );
+    void EndProcessing();
+
+protected:
+    uint   msgBeginPos;
+    int    msgBeginKeyPos;
+    double msgBeginTime;
+    uint   processMsg;
+    uint   processBeginPos;
+    double processBeginTime;
 };
 
 class NetServerBase
@@ -27,8 +86,8 @@ class NetServerBase
 public:
     virtual ~NetServerBase() = 0;
 
-    static NetServerBase* StartTcpServer( ushort port, std::function< void(NetConnection*) > callback );
-    static NetServerBase* StartWebSocketsServer( ushort port, string wss_credentials, std::function< void(NetConnection*) > callback );
+    static NetServerBase* StartTcpServer( ushort port, uint threads, std::function< void(NetConnection*) > callback );
+    static NetServerBase* StartWebSocketsServer( ushort port, uint threads, string wss_credentials, std::function< void(NetConnection*) > callback );
 };
 
 #endif // __NETWORKING__
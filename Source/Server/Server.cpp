@@ -20,6 +20,7 @@ NetServerBase*            FOServer::WebSocketsServer;
 ClVec                     FOServer::ConnectedClients;
 Mutex                     FOServer::ConnectedClientsLocker;
 FOServer::Statistics_     FOServer::Statistics;
+uint                      FOServer::NetStatisticsDumpPeriod;
 bool                      FOServer::RequestReloadClientScripts;
 LangPackVec               FOServer::LangPacks;
 Pragmas                   FOServer::ServerPropertyPragmas;
@@ -33,6 +34,7 @@ FOServer::ClientBannedVec FOServer::Banned;
 Mutex                     FOServer::BannedLocker;
 FOServer::UpdateFileVec   FOServer::UpdateFiles;
 UCharVec                  FOServer::UpdateFilesList;
+bool                      FOServer::RequestGenerateUpdateFiles;
 
 FOServer::FOServer()
 {
@@ -41,6 +43,7 @@ FOServer::FOServer()
     memzero( &Statistics, sizeof( Statistics ) );
     memzero( &ServerFunctions, sizeof( ServerFunctions ) );
     RequestReloadClientScripts = false;
+    RequestGenerateUpdateFiles = false;
     MEMORY_PROCESS( MEMORY_STATIC, sizeof( FOServer ) );
 }
 
@@ -59,7 +62,11 @@ void FOServer::Finish()
     if( DbHistory )
         DbHistory->StartChanges();
 
+    EntityMngr.FlushChangedProperties();
+    EntityMngr.PropertiesCoalescing = false;
+
     Script::RaiseInternalEvent( ServerFunctions.Finish );
+    Critter::FlushChangedCrTimeEvents();
     ItemMngr.RadioClear();
     EntityMngr.ClearEntities();
 
@@ -67,6 +74,11 @@ void FOServer::Finish()
     if( DbHistory )
         DbHistory->CommitChanges();
 
+    // Flush pending writes
+    DbStorage->StopWriteBehind();
+    if( DbHistory )
+        DbHistory->StopWriteBehind();
+
     // Logging clients
     LogToFunc( "LogToClients", FOServer::LogToClients, false );
     for( auto it = LogClients.begin(), end = LogClients.end(); it != end; ++it )
@@ -119,7 +131,7 @@ string FOServer::GetIngamePlayersStatistics()
     CrMngr.GetClients( players );
 
     string result = _str( "Players in game: {}\nConnections: {}\n", players.size(), conn_count );
-    result += "Name                 Id         Ip              Online  Cond     X     Y     Location and map\n";
+    result += "Name                 Id         Ip              Online  Cond     X     Y     Msgs  Frames Bytes    Location and map\n";
     for( Client* cl : players )
     {
         Map*      map = MapMngr.GetMap( cl->GetMapId() );
@@ -127,13 +139,64 @@ string FOServer::GetIngamePlayersStatistics()
 
         string    str_loc = _str( "{} ({}) {} ({})",
                                   map ? loc->GetName() : "", map ? loc->GetId() : 0, map ? map->GetName() : "", map ? map->GetId() : 0 );
-        result += _str( "{:<20} {:<10} {:<15} {:<7} {:<8} {:<5} {:<5} {}\n",
+        result += _str( "{:<20} {:<10} {:<15} {:<7} {:<8} {:<5} {:<5} {:<5} {:<6} {:<8} {}\n",
                         cl->Name, cl->GetId(), cl->GetIpStr(), cl->IsOffline() ? "No" : "Yes", cond_states_str[ cl->GetCond() ],
-                        map ? cl->GetHexX() : cl->GetWorldX(), map ? cl->GetHexY() : cl->GetWorldY(), map ? str_loc : "Global map" );
+                        map ? cl->GetHexX() : cl->GetWorldX(), map ? cl->GetHexY() : cl->GetWorldY(),
+                        cl->Connection->TickMessages, cl->Connection->TickFrames, cl->Connection->TickBytes, map ? str_loc : "Global map" );
     }
     return result;
 }
 
+string FOServer::GetNetStatistics()
+{
+    const uint top_count = 20;
+
+    string result;
+    auto   add_messages = [ &result ] ( const char* title, const NetMessagesStatistics & stats )
+    {
+        vector< uint > indices;
+        for( uint i = 0; i < NetMessagesStatistics::MaxMessages; i++ )
+            if( stats.Count[ i ] )
+                indices.push_back( i );
+        std::sort( indices.begin(), indices.end(), [ &stats ] ( uint a, uint b ) { return stats.Bytes[ a ] > stats.Bytes[ b ]; } );
+
+        result += _str( "{}\n", title );
+        result += "Message                          Count        Bytes          Avg      Time (ms)\n";
+        for( uint index : indices )
+        {
+            result += _str( "{:<32} {:<12} {:<14} {:<8} {:.3f}\n", NetMessagesStatistics::GetName( index ),
+                            stats.Count[ index ], stats.Bytes[ index ], stats.Bytes[ index ] / stats.Count[ index ], stats.Time[ index ] );
+        }
+    };
+    add_messages( "Sent messages:", NetConnection::SendStatistics );
+    add_messages( "\nReceived messages:", NetConnection::RecvStatistics );
+
+    // Connections with most traffic
+    ConnectedClientsLocker.Lock();
+    ClVec clients = ConnectedClients;
+    for( Client* cl : clients )
+        cl->AddRef();
+    ConnectedClientsLocker.Unlock();
+
+    std::sort( clients.begin(), clients.end(), [] ( Client * a, Client * b )
+               {
+                   return a->Connection->BytesSend + a->Connection->BytesRecv > b->Connection->BytesSend + b->Connection->BytesRecv;
+               } );
+
+    result += _str( "\nTop talkers:\n" );
+    result += "Name                 Ip              Sent msgs    Sent bytes     Recv msgs    Recv bytes\n";
+    for( uint i = 0; i < (uint) clients.size() && i < top_count; i++ )
+    {
+        NetConnection* conn = clients[ i ]->Connection;
+        result += _str( "{:<20} {:<15} {:<12} {:<14} {:<12} {}\n", clients[ i ]->Name, clients[ i ]->GetIpStr(),
+                        conn->MessagesSend, conn->BytesSend, conn->MessagesRecv, conn->BytesRecv );
+    }
+
+    for( Client* cl : clients )
+        cl->Release();
+    return result;
+}
+
 // Accesses
 void FOServer::GetAccesses( StrVec& client, StrVec& tester, StrVec& moder, StrVec& admin, StrVec& admin_names )
 {
@@ -255,6 +318,7 @@ void FOServer::LogicTick()
     // Process critters
     CritterVec critters;
     EntityMngr.GetCritters( critters );
+    double critters_begin = Timer::AccurateTick();
     for( Critter* cr : critters )
     {
         // Player specific
@@ -268,10 +332,12 @@ void FOServer::LogicTick()
         // Process logic
         ProcessCritter( cr );
     }
+    Statistics.CrittersTime = Timer::AccurateTick() - critters_begin;
 
     // Process maps
     MapVec maps;
     EntityMngr.GetMaps( maps );
+    double maps_begin = Timer::AccurateTick();
     for( Map* map : maps )
     {
         // Check for removing
@@ -279,8 +345,13 @@ void FOServer::LogicTick()
             continue;
 
         // Process logic
+        double map_begin = Timer::AccurateTick();
         map->Process();
+
+        map->ProcessTime = Timer::AccurateTick() - map_begin;
+        map->ProcessTimeMax = MAX( map->ProcessTimeMax, map->ProcessTime );
     }
+    Statistics.MapsTime = Timer::AccurateTick() - maps_begin;
 
     // Locations and maps garbage
     MapMngr.LocationGarbager();
@@ -301,10 +372,40 @@ void FOServer::LogicTick()
     Script::RunSuspended();
 
     // Commit changed to data base
+    Critter::FlushChangedCrTimeEvents();
+    EntityMngr.FlushChangedProperties();
     DbStorage->CommitChanges();
     if( DbHistory )
         DbHistory->CommitChanges();
 
+    // Send messages accumulated during cycle
+    uint tick_messages = 0;
+    uint tick_frames = 0;
+    uint tick_bytes = 0;
+    ConnectedClientsLocker.Lock();
+    for( Client* cl : ConnectedClients )
+    {
+        cl->Connection->Flush();
+        tick_messages += cl->Connection->TickMessages;
+        tick_frames += cl->Connection->TickFrames;
+        tick_bytes += cl->Connection->TickBytes;
+    }
+    ConnectedClientsLocker.Unlock();
+    Statistics.NetTickMessages = tick_messages;
+    Statistics.NetTickFrames = tick_frames;
+    Statistics.NetTickBytes = tick_bytes;
+
+    // Periodic dump of network statistics
+    static uint net_statistics_tick = Timer::FastTick();
+    if( NetStatisticsDumpPeriod && Timer::FastTick() - net_statistics_tick >= NetStatisticsDumpPeriod * 1000 )
+    {
+        net_statistics_tick = Timer::FastTick();
+        File net_statistics;
+        net_statistics.SetStr( GetNetStatistics() );
+        if( !net_statistics.SaveFile( "NetStatistics.txt" ) )
+            WriteLog( "Can't write network statistics file.\n" );
+    }
+
     // Fill statistics
     double frame_time = Timer::AccurateTick() - frame_begin;
     uint   loop_tick = (uint) frame_time;
@@ -339,6 +440,13 @@ void FOServer::LogicTick()
         RequestReloadClientScripts = false;
     }
 
+    // Update files changed on disk
+    if( RequestGenerateUpdateFiles )
+    {
+        RequestGenerateUpdateFiles = false;
+        GenerateUpdateFiles();
+    }
+
     // Sleep
     if( ServerGameSleep >= 0 )
         Thread::Sleep( ServerGameSleep );
@@ -418,15 +526,34 @@ void FOServer::DrawGui()
         Gui.Stats += _str( "Items: {}\n", ItemMngr.GetItemsCount() );
         Gui.Stats += _str( "Cycles per second: {}\n", Statistics.FPS );
         Gui.Stats += _str( "Cycle time: {}\n", Statistics.CycleTime );
+        Gui.Stats += _str( "Maps time: {:.3f}\n", Statistics.MapsTime );
+        Gui.Stats += _str( "Critters time: {:.3f}\n", Statistics.CrittersTime );
+        if( DbStorage )
+        {
+            Gui.Stats += _str( "Data base queue: {} (peak {})\n", DbStorage->GetWriteQueueSize(), DbStorage->GetWriteQueuePeak() );
+            Gui.Stats += _str( "Data base commit: {:.3f} (max {:.3f})\n", DbStorage->GetCommitTime(), DbStorage->GetCommitTimeMax() );
+        }
         uint seconds = Statistics.Uptime;
         Gui.Stats += _str( "Uptime: {:02}:{:02}:{:02}\n", seconds / 60 / 60, seconds / 60 % 60, seconds % 60 );
         Gui.Stats += _str( "KBytes Send: {}\n", Statistics.BytesSend / 1024 );
         Gui.Stats += _str( "KBytes Recv: {}\n", Statistics.BytesRecv / 1024 );
+        Gui.Stats += _str( "Net cycle: {} messages, {} frames, {} bytes\n", Statistics.NetTickMessages, Statistics.NetTickFrames, Statistics.NetTickBytes );
         Gui.Stats += _str( "Compress ratio: {}", (double) Statistics.DataReal / ( Statistics.DataCompressed ? Statistics.DataCompressed : 1 ) );
         ImGui::TextUnformatted( Gui.Stats.c_str(), Gui.Stats.c_str() + Gui.Stats.size() );
     }
     ImGui::End();
 
+    // Network
+    ImGui::SetNextWindowPos( Gui.NetworkPos, ImGuiCond_Once );
+    ImGui::SetNextWindowSize( Gui.DefaultSize, ImGuiCond_Once );
+    ImGui::SetNextWindowCollapsed( true, ImGuiCond_Once );
+    if( ImGui::Begin( "Network", nullptr, ImGuiWindowFlags_AlwaysAutoResize ) )
+    {
+        Gui.Stats = ( Started() ? GetNetStatistics() : "Waiting for server start..." );
+        ImGui::TextUnformatted( Gui.Stats.c_str(), Gui.Stats.c_str() + Gui.Stats.size() );
+    }
+    ImGui::End();
+
     // Control panel
     ImGui::SetNextWindowPos( Gui.ControlPanelPos, ImGuiCond_Once );
     ImGui::SetNextWindowSize( Gui.DefaultSize, ImGuiCond_Once );
@@ -508,6 +635,9 @@ void FOServer::Process( Client* cl )
         return;
     }
 
+    // Take data received by network thread
+    cl->Connection->Receive();
+
     uint msg = 0;
     if( cl->GameState == STATE_CONNECTED )
     {
@@ -518,6 +648,7 @@ void FOServer::Process( Client* cl )
         if( cl->Connection->Bin.NeedProcess() )
         {
             cl->Connection->Bin >> msg;
+            cl->Connection->BeginProcessing( msg );
 
             uint tick = Timer::FastTick();
             switch( msg )
@@ -543,6 +674,10 @@ void FOServer::Process( Client* cl )
                 Process_Ping( cl );
                 BIN_END( cl );
                 break;
+            case NETMSG_COMPRESSION:
+                Process_Compression( cl );
+                BIN_END( cl );
+                break;
             case NETMSG_LOGIN:
                 Process_LogIn( cl );
                 BIN_END( cl );
@@ -563,6 +698,10 @@ void FOServer::Process( Client* cl )
                 Process_UpdateFileData( cl );
                 BIN_END( cl );
                 break;
+            case NETMSG_GET_UPDATE_FILE_PART:
+                Process_UpdateFilePart( cl );
+                BIN_END( cl );
+                break;
             case NETMSG_RPC:
                 Script::HandleRpc( cl );
                 BIN_END( cl );
@@ -600,6 +739,7 @@ void FOServer::Process( Client* cl )
         if( cl->Connection->Bin.NeedProcess() )
         {
             cl->Connection->Bin >> msg;
+            cl->Connection->BeginProcessing( msg );
 
             uint tick = Timer::FastTick();
             switch( msg )
@@ -654,6 +794,7 @@ void FOServer::Process( Client* cl )
                 break;
             }
             cl->Connection->Bin >> msg;
+            cl->Connection->BeginProcessing( msg );
 
             uint tick = Timer::FastTick();
             switch( msg )
@@ -1043,6 +1184,12 @@ void FOServer::Process_CommandReal( NetBuffer& buf, LogFunc logcb, Client* cl_,
         case 5:
             result = ItemMngr.GetItemsStatistics();
             break;
+        case 6:
+            result = GetNetStatistics();
+            break;
+        case 7:
+            result = Script::GetEventsStatistics();
+            break;
         default:
             break;
         }
@@ -1874,6 +2021,16 @@ bool FOServer::InitReal()
 {
     WriteLog( "***   Starting initialization   ***\n" );
 
+    // Startup phases timings
+    double start_tick = Timer::AccurateTick();
+    double phase_tick = start_tick;
+    auto   log_phase = [ &phase_tick ] ( const char* phase_name )
+    {
+        double tick = Timer::AccurateTick();
+        WriteLog( "Initialization phase '{}' complete, time {} ms.\n", phase_name, (uint) ( tick - phase_tick ) );
+        phase_tick = tick;
+    };
+
     File::InitDataFiles( "./" );
 
     // Delete intermediate files if engine have been updated
@@ -1921,20 +2078,24 @@ bool FOServer::InitReal()
         DbHistory->StartChanges();
 
     PropertyRegistrator::GlobalSetCallbacks.push_back( EntitySetValue );
+    log_phase( "Data base" );
 
     if( !InitScriptSystem() )
         return false;                                  // Script system
+    log_phase( "Scripts" );
     if( !InitLangPacks( LangPacks ) )
         return false;                                  // Language packs
     if( !ReloadClientScripts() )
         return false;                                  // Client scripts, after language packs initialization
     LoadBans();
+    log_phase( "Client scripts" );
 
     // Managers
     if( !DlgMngr.LoadDialogs() )
         return false;                    // Dialog manager
     if( !ProtoMngr.LoadProtosFromFiles() )
         return false;
+    log_phase( "Dialogs and protos" );
 
     // Language packs
     if( !InitLangPacksDialogs( LangPacks ) )
@@ -1977,6 +2138,7 @@ bool FOServer::InitReal()
     Timer::UpdateTick();
     if( !Script::RunModuleInitFunctions() )
         return false;
+    log_phase( "Scripts post init" );
 
     // Update files
     StrVec resource_names;
@@ -1985,6 +2147,7 @@ bool FOServer::InitReal()
     // Validate protos resources
     if( !ProtoMngr.ValidateProtoResources( resource_names ) )
         return false;
+    log_phase( "Update files" );
 
     // Initialization script
     Timer::UpdateTick();
@@ -2017,12 +2180,24 @@ bool FOServer::InitReal()
         WriteLog( "Start script fail.\n" );
         return false;
     }
+    log_phase( "World" );
 
     // Commit data base changes
+    Critter::FlushChangedCrTimeEvents();
     DbStorage->CommitChanges();
     if( DbHistory )
         DbHistory->CommitChanges();
 
+    // Move data base writes out of logic thread
+    uint db_write_queue = MainConfig->GetInt( "", "DbWriteBehindQueue", 0 );
+    if( db_write_queue )
+    {
+        WriteLog( "Data base write behind enabled, queue size {}.\n", db_write_queue );
+        DbStorage->StartWriteBehind( db_write_queue );
+        if( DbHistory )
+            DbHistory->StartWriteBehind( db_write_queue );
+    }
+
     // End of initialization
     Statistics.BytesSend = 0;
     Statistics.BytesRecv = 0;
@@ -2033,17 +2208,31 @@ bool FOServer::InitReal()
     // Net
     ushort port = MainConfig->GetInt( "", "Port", 4000 );
     string wss_credentials = MainConfig->GetStr( "", "WssCredentials", "" );
+    NetConnection::BatchSize = MainConfig->GetInt( "", "NetBatchSize", 0 );
+    NetConnection::CompressionLevel = CLAMP( MainConfig->GetInt( "", "NetCompressionLevel", Z_BEST_SPEED ), Z_BEST_SPEED, Z_BEST_COMPRESSION );
+    NetConnection::CompressionAdaptive = MainConfig->GetInt( "", "NetCompressionAdaptive", 0 ) != 0;
+    if( NetConnection::BatchSize )
+        WriteLog( "Network messages batching enabled, batch size {}.\n", NetConnection::BatchSize );
+    EntityMngr.PropertiesCoalescing = MainConfig->GetInt( "", "PropertiesCoalescing", 0 ) != 0;
+    if( EntityMngr.PropertiesCoalescing )
+        WriteLog( "Property changes coalescing enabled.\n" );
+    NetStatisticsDumpPeriod = MainConfig->GetInt( "", "NetStatisticsDumpPeriod", 0 );
+
+    uint   net_threads = MainConfig->GetInt( "", "NetWorkThreads", 1 );
 
-    WriteLog( "Starting server on ports {} and {}.\n", port, port + 1 );
+    WriteLog( "Starting server on ports {} and {}, network threads {}.\n", port, port + 1, net_threads );
 
-    if( !( TcpServer = NetServerBase::StartTcpServer( port, FOServer::OnNewConnection ) ) )
+    if( !( TcpServer = NetServerBase::StartTcpServer( port, net_threads, FOServer::OnNewConnection ) ) )
         return false;
-    if( !( WebSocketsServer = NetServerBase::StartWebSocketsServer( port + 1, wss_credentials, FOServer::OnNewConnection ) ) )
+    if( !( WebSocketsServer = NetServerBase::StartWebSocketsServer( port + 1, net_threads, wss_credentials, FOServer::OnNewConnection ) ) )
         return false;
 
     // Script timeouts
     Script::SetRunTimeout( GameOpt.ScriptRunSuspendTimeout, GameOpt.ScriptRunMessageTimeout );
 
+    log_phase( "Network" );
+    WriteLog( "Initialization time {} ms.\n", (uint) ( Timer::AccurateTick() - start_tick ) );
+
     Active = true;
     return true;
 }
@@ -2354,6 +2543,53 @@ void FOServer::LoadBans()
     ProcessBans();
 }
 
+void FOServer::AddStreamedUpdateFile( const string& dir, const string& file_path )
+{
+    // Loaded once for hash calculation, data sent to clients directly from disk
+    // Size and write time are remembered to detect changes made after hashing
+    UpdateFile update_file;
+    update_file.Data = nullptr;
+    update_file.Path = _str( dir + file_path ).formatPath();
+
+    void* f = FileOpen( update_file.Path, false );
+    if( !f )
+    {
+        WriteLog( "Can't open file '{}'.\n", update_file.Path );
+        return;
+    }
+
+    update_file.Size = FileGetSize( f );
+    update_file.WriteTime = FileGetWriteTime( f );
+    UCharVec data( update_file.Size );
+    bool     read_ok = ( !update_file.Size || FileRead( f, &data[ 0 ], update_file.Size ) );
+    FileClose( f );
+    if( !read_ok )
+    {
+        WriteLog( "Can't read file '{}'.\n", update_file.Path );
+        return;
+    }
+
+    // Already compressed files are sent without network compression
+    string ext = _str( file_path ).getFileExtension();
+    update_file.Stored = ( ext == "zip" || ext == "dat" || ext == "7z" || ext == "gz" || ext == "ogg" || ext == "png" || ext == "jpg" );
+    UpdateFiles.push_back( update_file );
+
+    // Chunks allow clients to download only changed parts of file
+    UIntVec chunk_sizes, chunk_hashes;
+    Crypt.SplitToChunks( data.data(), update_file.Size, chunk_sizes, chunk_hashes );
+
+    WriteData( UpdateFilesList, (short) file_path.length() );
+    WriteDataArr( UpdateFilesList, file_path.c_str(), (uint) file_path.length() );
+    WriteData( UpdateFilesList, update_file.Size );
+    WriteData( UpdateFilesList, Crypt.MurmurHash2( data.data(), update_file.Size ) );
+    WriteData( UpdateFilesList, (uint) chunk_sizes.size() );
+    for( size_t i = 0; i < chunk_sizes.size(); i++ )
+    {
+        WriteData( UpdateFilesList, chunk_sizes[ i ] );
+        WriteData( UpdateFilesList, chunk_hashes[ i ] );
+    }
+}
+
 void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec* resource_names /* = nullptr */ )
 {
     if( !first_generation && UpdateFiles.empty() )
@@ -2377,6 +2613,7 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
         SAFEDELA( it->Data );
     UpdateFiles.clear();
     UpdateFilesList.clear();
+    WriteData( UpdateFilesList, (uint) UPDATE_FILES_LIST_VERSION );
 
     // Fill MSG
     UpdateFile update_file;
@@ -2389,7 +2626,7 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
 
             string msg_cache_name = lang_pack.GetMsgCacheName( i );
 
-            memzero( &update_file, sizeof( update_file ) );
+            update_file = UpdateFile();
             update_file.Size = (uint) msg_data.size();
             update_file.Data = new uchar[ update_file.Size ];
             memcpy( update_file.Data, &msg_data[ 0 ], update_file.Size );
@@ -2399,6 +2636,7 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
             WriteDataArr( UpdateFilesList, msg_cache_name.c_str(), (uint) msg_cache_name.length() );
             WriteData( UpdateFilesList, update_file.Size );
             WriteData( UpdateFilesList, Crypt.MurmurHash2( update_file.Data, update_file.Size ) );
+            WriteData( UpdateFilesList, (uint) 0 );
         }
     }
 
@@ -2406,7 +2644,7 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
     UCharVec proto_items_data;
     ProtoMngr.GetBinaryData( proto_items_data );
 
-    memzero( &update_file, sizeof( update_file ) );
+    update_file = UpdateFile();
     update_file.Size = (uint) proto_items_data.size();
     update_file.Data = new uchar[ update_file.Size ];
     memcpy( update_file.Data, &proto_items_data[ 0 ], update_file.Size );
@@ -2417,29 +2655,13 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
     WriteDataArr( UpdateFilesList, protos_cache_name.c_str(), (uint) protos_cache_name.length() );
     WriteData( UpdateFilesList, update_file.Size );
     WriteData( UpdateFilesList, Crypt.MurmurHash2( update_file.Data, update_file.Size ) );
+    WriteData( UpdateFilesList, (uint) 0 );
 
     // Fill files
     StrVec file_paths;
     File::GetFolderFileNames( "Update/", true, "", file_paths );
     for( const string& file_path : file_paths )
-    {
-        File file;
-        if( !file.LoadFile( "Update/" + file_path ) )
-        {
-            WriteLog( "Can't load file 'Update/{}'.\n", file_path );
-            continue;
-        }
-
-        memzero( &update_file, sizeof( update_file ) );
-        update_file.Size = file.GetFsize();
-        update_file.Data = file.ReleaseBuffer();
-        UpdateFiles.push_back( update_file );
-
-        WriteData( UpdateFilesList, (short) file_path.length() );
-        WriteDataArr( UpdateFilesList, file_path.c_str(), (uint) file_path.length() );
-        WriteData( UpdateFilesList, update_file.Size );
-        WriteData( UpdateFilesList, Crypt.MurmurHash2( update_file.Data, update_file.Size ) );
-    }
+        AddStreamedUpdateFile( "Update/", file_path );
 
     WriteLog( "Generate update files complete.\n" );
 
@@ -2451,24 +2673,7 @@ void FOServer::GenerateUpdateFiles( bool first_generation /* = false */, StrVec*
     StrVec binary_paths;
     File::GetFolderFileNames( "Binaries/", true, "", binary_paths );
     for( const string& file_path : binary_paths )
-    {
-        File file;
-        if( !file.LoadFile( "Binaries/" + file_path ) )
-        {
-            WriteLog( "Can't load file 'Binaries/{}'.\n", file_path );
-            continue;
-        }
-
-        memzero( &update_file, sizeof( update_file ) );
-        update_file.Size = file.GetFsize();
-        update_file.Data = file.ReleaseBuffer();
-        UpdateFiles.push_back( update_file );
-
-        WriteData( UpdateFilesList, (short) file_path.length() );
-        WriteDataArr( UpdateFilesList, file_path.c_str(), (uint) file_path.length() );
-        WriteData( UpdateFilesList, update_file.Size );
-        WriteData( UpdateFilesList, Crypt.MurmurHash2( update_file.Data, update_file.Size ) );
-    }
+        AddStreamedUpdateFile( "Binaries/", file_path );
 
     // Complete files list
     WriteData( UpdateFilesList, (short) -1 );
@@ -2483,26 +2688,16 @@ void FOServer::EntitySetValue( Entity* entity, Property* prop, void* cur_value,
     if( !entity->Id || prop->IsTemporary() )
         return;
 
-    DataBase::Value value = entity->Props.SavePropertyToDbValue( prop );
+    // History written for each change, storage may be deferred to take only latest value of tick
+    bool deferred = EntityMngr.DeferPropertyStore( entity, prop, EntityStoreValue );
+    bool history = ( DbHistory && !prop->IsNoHistory() );
+    if( deferred && !history )
+        return;
 
-    if( entity->Type == EntityType::Location )
-        DbStorage->Update( "Locations", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Map )
-        DbStorage->Update( "Maps", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Npc )
-        DbStorage->Update( "Critters", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Item )
-        DbStorage->Update( "Items", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Custom )
-        DbStorage->Update( entity->Props.GetRegistrator()->GetClassName() + "s", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Client )
-        DbStorage->Update( "Players", entity->Id, prop->GetName(), value );
-    else if( entity->Type == EntityType::Global )
-        DbStorage->Update( "Globals", entity->Id, prop->GetName(), value );
-    else
-        RUNTIME_ASSERT( !"Unreachable place" );
+    DataBase::Value value = entity->Props.SavePropertyToDbValue( prop );
 
-    if( DbHistory && !prop->IsNoHistory() )
+    // Write history before storage, value moved to storage changes
+    if( history )
     {
         uint id = Globals->GetHistoryRecordsId();
         Globals->SetHistoryRecordsId( id + 1 );
@@ -2516,20 +2711,48 @@ void FOServer::EntitySetValue( Entity* entity, Property* prop, void* cur_value,
         doc[ "Value" ] = value;
 
         if( entity->Type == EntityType::Location )
-            DbHistory->Insert( "LocationsHistory", id, doc );
+            DbHistory->Insert( "LocationsHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Map )
-            DbHistory->Insert( "MapsHistory", id, doc );
+            DbHistory->Insert( "MapsHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Npc )
-            DbHistory->Insert( "CrittersHistory", id, doc );
+            DbHistory->Insert( "CrittersHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Item )
-            DbHistory->Insert( "ItemsHistory", id, doc );
+            DbHistory->Insert( "ItemsHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Custom )
-            DbHistory->Insert( entity->Props.GetRegistrator()->GetClassName() + "sHistory", id, doc );
+            DbHistory->Insert( entity->Props.GetRegistrator()->GetClassName() + "sHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Client )
-            DbHistory->Insert( "PlayersHistory", id, doc );
+            DbHistory->Insert( "PlayersHistory", id, std::move( doc ) );
         else if( entity->Type == EntityType::Global )
-            DbHistory->Insert( "GlobalsHistory", id, doc );
+            DbHistory->Insert( "GlobalsHistory", id, std::move( doc ) );
         else
             RUNTIME_ASSERT( !"Unreachable place" );
     }
+
+    if( !deferred )
+        StoreEntityValue( entity, prop, std::move( value ) );
+}
+
+void FOServer::EntityStoreValue( Entity* entity, Property* prop, void* cur_value, void* old_value )
+{
+    StoreEntityValue( entity, prop, entity->Props.SavePropertyToDbValue( prop ) );
+}
+
+void FOServer::StoreEntityValue( Entity* entity, Property* prop, DataBase::Value value )
+{
+    if( entity->Type == EntityType::Location )
+        DbStorage->Update( "Locations", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Map )
+        DbStorage->Update( "Maps", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Npc )
+        DbStorage->Update( "Critters", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Item )
+        DbStorage->Update( "Items", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Custom )
+        DbStorage->Update( entity->Props.GetRegistrator()->GetClassName() + "s", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Client )
+        DbStorage->Update( "Players", entity->Id, prop->GetName(), std::move( value ) );
+    else if( entity->Type == EntityType::Global )
+        DbStorage->Update( "Globals", entity->Id, prop->GetName(), std::move( value ) );
+    else
+        RUNTIME_ASSERT( !"Unreachable place" );
 }
@@ -41,6 +41,8 @@ public:
     ~FOServer();
 
     static void EntitySetValue( Entity* entity, Property* prop, void* cur_value, void* old_value );
+    static void EntityStoreValue( Entity* entity, Property* prop, void* cur_value, void* old_value );
+    static void StoreEntityValue( Entity* entity, Property* prop, DataBase::Value value );
 
     // Net process
     static void Process_ParseToGame( Client* cl );
@@ -48,6 +50,7 @@ public:
     static void Process_Update( Client* cl );
     static void Process_UpdateFile( Client* cl );
     static void Process_UpdateFileData( Client* cl );
+    static void Process_UpdateFilePart( Client* cl );
     static void Process_CreateClient( Client* cl );
     static void Process_LogIn( Client*& cl );
     static void Process_Dir( Client* cl );
@@ -57,6 +60,7 @@ public:
     static void Process_Dialog( Client* cl );
     static void Process_GiveMap( Client* cl );
     static void Process_Ping( Client* cl );
+    static void Process_Compression( Client* cl );
     static void Process_Property( Client* cl, uint data_size );
 
     static void Send_MapData( Client* cl, ProtoMap* pmap, bool send_tiles, bool send_scenery );
@@ -66,12 +70,17 @@ public:
     {
         uint   Size;
         uchar* Data;
+        string Path;      // Not loaded to memory, read by portions from disk
+        uint64 WriteTime; // Of streamed file at hashing
+        bool   Stored;    // Already compressed, sent without network compression
     };
     typedef vector< UpdateFile > UpdateFileVec;
     static UpdateFileVec UpdateFiles;
     static UCharVec      UpdateFilesList;
 
+    static bool RequestGenerateUpdateFiles;
     static void GenerateUpdateFiles( bool first_generation = false, StrVec* resource_names = nullptr );
+    static void AddStreamedUpdateFile( const string& dir, const string& file_path );
 
     // Actions
     static bool Act_Move( Critter* cr, ushort hx, ushort hy, uint move_params );
@@ -111,6 +120,7 @@ public:
     static void OnSendCritterValue( Entity* entity, Property* prop );
     static void OnSendMapValue( Entity* entity, Property* prop );
     static void OnSendLocationValue( Entity* entity, Property* prop );
+    static void OnSetCritterLookDistance( Entity* entity, Property* prop, void* cur_value, void* old_value );
 
     // Items
     static Item* CreateItemOnHex( Map* map, ushort hx, ushort hy, hash pid, uint count, Properties* props, bool check_blocks );
@@ -181,6 +191,7 @@ public:
         ImVec2 ButtonSize = ImVec2( 200, 30 );
         ImVec2 LogPos = ImVec2( 140, 140 );
         ImVec2 LogSize = ImVec2( 800, 600 );
+        ImVec2 NetworkPos = ImVec2( 160, 160 );
         string CurLog;
         string WholeLog;
         string Stats;
@@ -251,9 +262,20 @@ public:
         uint  LoopMin;
         uint  LoopMax;
         uint  LagsCount;
+
+        double MapsTime;
+        double CrittersTime;
+
+        uint   NetTickMessages;
+        uint   NetTickFrames;
+        uint   NetTickBytes;
     } static Statistics;
 
     static string GetIngamePlayersStatistics();
+    static string GetNetStatistics();
+
+    // Write network statistics to file with this period, in seconds
+    static uint NetStatisticsDumpPeriod;
 
     // Script functions
     struct SScriptFunc
@@ -2,6 +2,7 @@
 #include "Log.h"
 #include "Exception.h"
 #include "Timer.h"
+#include "FileSystem.h"
 
 void FOServer::ProcessCritter( Critter* cr )
 {
@@ -20,24 +21,15 @@ void FOServer::ProcessCritter( Critter* cr )
 
     // Internal misc/drugs time events
     // One event per cycle
-    if( cr->IsNonEmptyTE_FuncNum() )
+    CrTimeEventVec& time_events = cr->GetCrTimeEvents();
+    if( !time_events.empty() )
     {
-        CScriptArray* te_next_time = cr->GetTE_NextTime();
-        uint          next_time = *(uint*) te_next_time->At( 0 );
+        uint next_time = time_events.front().NextTime;
         if( !next_time || GameOpt.FullSecond >= next_time )
         {
-            CScriptArray* te_func_num = cr->GetTE_FuncNum();
-            CScriptArray* te_rate = cr->GetTE_Rate();
-            CScriptArray* te_identifier = cr->GetTE_Identifier();
-            RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
-            RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
-            RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
-            hash func_num = *(hash*) te_func_num->At( 0 );
-            uint rate = *(hash*) te_rate->At( 0 );
-            int  identifier = *(hash*) te_identifier->At( 0 );
-            te_func_num->Release();
-            te_rate->Release();
-            te_identifier->Release();
+            hash func_num = time_events.front().FuncNum;
+            uint rate = time_events.front().Rate;
+            int  identifier = time_events.front().Identifier;
 
             cr->EraseCrTimeEvent( 0 );
 
@@ -51,7 +43,6 @@ void FOServer::ProcessCritter( Critter* cr )
             if( time )
                 cr->AddCrTimeEvent( func_num, rate, time, identifier );
         }
-        te_next_time->Release();
     }
 
     // Client
@@ -132,6 +123,7 @@ bool FOServer::Act_Move( Critter* cr, ushort hx, ushort hy, uint move_params )
     map->UnsetFlagCritter( fx, fy, multihex, is_dead );
     cr->SetHexX( hx );
     cr->SetHexY( hy );
+    map->MoveCritterCell( cr, fx, fy );
     map->SetFlagCritter( hx, hy, multihex, is_dead );
 
     // Set dir
@@ -276,8 +268,44 @@ void FOServer::Process_UpdateFile( Client* cl )
         return;
     }
 
+    if( cl->UpdateFileHandle )
+    {
+        FileClose( cl->UpdateFileHandle );
+        cl->UpdateFileHandle = nullptr;
+    }
+
     cl->UpdateFileIndex = file_index;
-    cl->UpdateFilePortion = 0;
+    cl->UpdateFileOffset = 0;
+    cl->UpdateFileEnd = UpdateFiles[ file_index ].Size;
+    Process_UpdateFileData( cl );
+}
+
+void FOServer::Process_UpdateFilePart( Client* cl )
+{
+    uint file_index;
+    uint offset;
+    uint size;
+    cl->Connection->Bin >> file_index;
+    cl->Connection->Bin >> offset;
+    cl->Connection->Bin >> size;
+
+    if( file_index >= (uint) UpdateFiles.size() || !size || offset >= UpdateFiles[ file_index ].Size ||
+        size > UpdateFiles[ file_index ].Size - offset )
+    {
+        WriteLog( "Wrong file part {} {} {}, client ip '{}'.\n", file_index, offset, size, cl->GetIpStr() );
+        cl->Disconnect();
+        return;
+    }
+
+    if( cl->UpdateFileHandle )
+    {
+        FileClose( cl->UpdateFileHandle );
+        cl->UpdateFileHandle = nullptr;
+    }
+
+    cl->UpdateFileIndex = file_index;
+    cl->UpdateFileOffset = offset;
+    cl->UpdateFileEnd = offset + size;
     Process_UpdateFileData( cl );
 }
 
@@ -291,10 +319,11 @@ void FOServer::Process_UpdateFileData( Client* cl )
     }
 
     UpdateFile& update_file = UpdateFiles[ cl->UpdateFileIndex ];
-    uint        offset = cl->UpdateFilePortion * FILE_UPDATE_PORTION;
+    uint        offset = cl->UpdateFileOffset;
+    bool        last_portion = ( offset + FILE_UPDATE_PORTION >= cl->UpdateFileEnd );
 
-    if( offset + FILE_UPDATE_PORTION < update_file.Size )
-        cl->UpdateFilePortion++;
+    if( !last_portion )
+        cl->UpdateFileOffset += FILE_UPDATE_PORTION;
     else
         cl->UpdateFileIndex = -1;
 
@@ -302,20 +331,59 @@ void FOServer::Process_UpdateFileData( Client* cl )
         return;
 
     uchar data[ FILE_UPDATE_PORTION ];
-    uint  remaining_size = update_file.Size - offset;
-    if( remaining_size >= sizeof( data ) )
+    uint  portion_size = MIN( cl->UpdateFileEnd - offset, (uint) sizeof( data ) );
+    if( update_file.Data )
     {
-        memcpy( data, &update_file.Data[ offset ], sizeof( data ) );
+        memcpy( data, &update_file.Data[ offset ], portion_size );
     }
     else
     {
-        memcpy( data, &update_file.Data[ offset ], remaining_size );
-        memzero( &data[ remaining_size ], sizeof( data ) - remaining_size );
+        // Stream from disk, file kept opened until last portion of requested range
+        if( !cl->UpdateFileHandle )
+        {
+            cl->UpdateFileHandle = FileOpen( update_file.Path, false );
+            if( cl->UpdateFileHandle && offset )
+                FileSetPointer( cl->UpdateFileHandle, offset, SEEK_SET );
+        }
+
+        // File edited after hashing, client would receive data that not match to its hash
+        if( cl->UpdateFileHandle && ( FileGetSize( cl->UpdateFileHandle ) != update_file.Size ||
+                                      FileGetWriteTime( cl->UpdateFileHandle ) != update_file.WriteTime ) )
+        {
+            WriteLog( "Update file '{}' changed on disk, regenerate update files.\n", update_file.Path );
+            FileClose( cl->UpdateFileHandle );
+            cl->UpdateFileHandle = nullptr;
+            cl->UpdateFileIndex = -1;
+            cl->Disconnect();
+            RequestGenerateUpdateFiles = true;
+            return;
+        }
+
+        if( !cl->UpdateFileHandle || !FileRead( cl->UpdateFileHandle, data, portion_size ) )
+        {
+            WriteLog( "Can't read update file '{}', client ip '{}'.\n", update_file.Path, cl->GetIpStr() );
+            if( cl->UpdateFileHandle )
+                FileClose( cl->UpdateFileHandle );
+            cl->UpdateFileHandle = nullptr;
+            cl->UpdateFileIndex = -1;
+            cl->Disconnect();
+            return;
+        }
+
+        if( last_portion )
+        {
+            FileClose( cl->UpdateFileHandle );
+            cl->UpdateFileHandle = nullptr;
+        }
     }
 
+    uint msg_len = sizeof( NETMSG_UPDATE_FILE_DATA ) + sizeof( msg_len ) + portion_size;
+    cl->Connection->SetCompressionStored( update_file.Stored && !last_portion );
+
     BOUT_BEGIN( cl );
     cl->Connection->Bout << NETMSG_UPDATE_FILE_DATA;
-    cl->Connection->Bout.Push( data, sizeof( data ) );
+    cl->Connection->Bout << msg_len;
+    cl->Connection->Bout.Push( data, portion_size );
     BOUT_END( cl );
 }
 
@@ -1058,6 +1126,20 @@ void FOServer::Process_Ping( Client* cl )
     BOUT_END( cl );
 }
 
+void FOServer::Process_Compression( Client* cl )
+{
+    uchar codec;
+
+    cl->Connection->Bin >> codec;
+    CHECK_IN_BUFF_ERROR( cl );
+
+    if( !cl->Connection->SetCompression( codec ) )
+    {
+        WriteLog( "Wrong compression {} request, client ip '{}'.\n", codec, cl->GetIpStr() );
+        cl->Disconnect();
+    }
+}
+
 void FOServer::Process_Property( Client* cl, uint data_size )
 {
     uint              msg_len = 0;
@@ -1204,6 +1286,9 @@ void FOServer::Process_Property( Client* cl, uint data_size )
 
 void FOServer::OnSendGlobalValue( Entity* entity, Property* prop )
 {
+    if( EntityMngr.DeferPropertySend( entity, prop, OnSendGlobalValue ) )
+        return;
+
     if( ( prop->GetAccess() & Property::PublicMask ) != 0 )
     {
         ClVec players;
@@ -1218,6 +1303,9 @@ void FOServer::OnSendGlobalValue( Entity* entity, Property* prop )
 
 void FOServer::OnSendCritterValue( Entity* entity, Property* prop )
 {
+    if( EntityMngr.DeferPropertySend( entity, prop, OnSendCritterValue ) )
+        return;
+
     Critter* cr = (Critter*) entity;
 
     bool     is_public = ( prop->GetAccess() & Property::PublicMask ) != 0;
@@ -1228,8 +1316,20 @@ void FOServer::OnSendCritterValue( Entity* entity, Property* prop )
         cr->SendA_Property( NetProperty::Critter, prop, cr );
 }
 
+void FOServer::OnSetCritterLookDistance( Entity* entity, Property* prop, void* cur_value, void* old_value )
+{
+    // Keep map look radius as upper bound, critter may be stationary and never check visibility itself
+    Critter* cr = (Critter*) entity;
+    Map*     map = ( cr->GetMapId() ? MapMngr.GetMap( cr->GetMapId() ) : nullptr );
+    if( map )
+        map->UpdateCrittersLookRadius( MAX( *(uint*) cur_value, GameOpt.LookMinimum ) );
+}
+
 void FOServer::OnSendMapValue( Entity* entity, Property* prop )
 {
+    if( EntityMngr.DeferPropertySend( entity, prop, OnSendMapValue ) )
+        return;
+
     if( ( prop->GetAccess() & Property::PublicMask ) != 0 )
     {
         Map* map = (Map*) entity;
@@ -1239,6 +1339,9 @@ void FOServer::OnSendMapValue( Entity* entity, Property* prop )
 
 void FOServer::OnSendLocationValue( Entity* entity, Property* prop )
 {
+    if( EntityMngr.DeferPropertySend( entity, prop, OnSendLocationValue ) )
+        return;
+
     if( ( prop->GetAccess() & Property::PublicMask ) != 0 )
     {
         Location* loc = (Location*) entity;
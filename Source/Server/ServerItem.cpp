@@ -32,6 +32,9 @@ Item* FOServer::CreateItemOnHex( Map* map, ushort hx, ushort hy, hash pid, uint
 
 void FOServer::OnSendItemValue( Entity* entity, Property* prop )
 {
+    if( EntityMngr.DeferPropertySend( entity, prop, OnSendItemValue ) )
+        return;
+
     Item* item = (Item*) entity;
     #pragma MESSAGE( "Clean up server 0 and -1 item ids" )
     if( item->Id && item->Id != uint( -1 ) )
@@ -122,6 +122,15 @@ bool FOServer::InitScriptSystem()
     if( ServerBind::Bind( engine, registrators ) )
         return false;
 
+    // External JIT compiler, before modules building
+    string jit_compiler = MainConfig->GetStr( "", "ScriptJitCompiler", "" );
+    if( !jit_compiler.empty() && !Script::InitJitCompiler( jit_compiler ) )
+    {
+        Script::Finish();
+        WriteLog( "JIT compiler initialization fail.\n" );
+        return false;
+    }
+
     // Load script modules
     Script::Undef( "" );
     Script::Define( "__SERVER" );
@@ -203,6 +212,10 @@ bool FOServer::InitScriptSystem()
     Globals = new GlobalVars();
     Critter::SetPropertyRegistrator( registrators[ 1 ] );
     Critter::PropertiesRegistrator->SetNativeSendCallback( OnSendCritterValue );
+    Critter::PropertiesRegistrator->SetNativeSetCallback( "LookDistance", OnSetCritterLookDistance );
+    Critter::PropertiesRegistrator->SetNativeSetCallback( "ShowCritterDist1", OnSetCritterLookDistance );
+    Critter::PropertiesRegistrator->SetNativeSetCallback( "ShowCritterDist2", OnSetCritterLookDistance );
+    Critter::PropertiesRegistrator->SetNativeSetCallback( "ShowCritterDist3", OnSetCritterLookDistance );
     Item::SetPropertyRegistrator( registrators[ 2 ] );
     Item::PropertiesRegistrator->SetNativeSendCallback( OnSendItemValue );
     Item::PropertiesRegistrator->SetNativeSetCallback( "Count", OnSetItemCount );
@@ -1540,23 +1553,19 @@ uint FOServer::SScriptFunc::Crit_GetTimeEvents( Critter* cr, int identifier, CSc
     if( cr->IsDestroyed )
         SCRIPT_ERROR_R0( "Attempt to call method on destroyed object." );
 
-    CScriptArray* te_identifier = cr->GetTE_Identifier();
-    UIntVec       te_vec;
-    for( uint i = 0, j = te_identifier->GetSize(); i < j; i++ )
+    CrTimeEventVec& time_events = cr->GetCrTimeEvents();
+    UIntVec         te_vec;
+    for( uint i = 0, j = (uint) time_events.size(); i < j; i++ )
     {
-        if( *(int*) te_identifier->At( i ) == identifier )
+        if( time_events[ i ].Identifier == identifier )
             te_vec.push_back( i );
     }
-    te_identifier->Release();
 
     uint size = (uint) te_vec.size();
     if( !size || ( !indexes && !durations && !rates ) )
         return size;
 
-    CScriptArray* te_next_time = nullptr;
-    CScriptArray* te_rate = nullptr;
-
-    uint          indexes_size = 0, durations_size = 0, rates_size = 0;
+    uint indexes_size = 0, durations_size = 0, rates_size = 0;
     if( indexes )
     {
         indexes_size = indexes->GetSize();
@@ -1564,41 +1573,32 @@ uint FOServer::SScriptFunc::Crit_GetTimeEvents( Critter* cr, int identifier, CSc
     }
     if( durations )
     {
-        te_next_time = cr->GetTE_NextTime();
-        RUNTIME_ASSERT( te_next_time->GetSize() == te_identifier->GetSize() );
         durations_size = durations->GetSize();
         durations->Resize( durations_size + size );
     }
     if( rates )
     {
-        te_rate = cr->GetTE_Rate();
-        RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
         rates_size = rates->GetSize();
         rates->Resize( rates_size + size );
     }
 
     for( uint i = 0; i < size; i++ )
     {
+        CrTimeEvent& te = time_events[ te_vec[ i ] ];
         if( indexes )
         {
             *(uint*) indexes->At( indexes_size + i ) = te_vec[ i ];
         }
         if( durations )
         {
-            uint next_time = *(uint*) te_next_time->At( te_vec[ i ] );
-            *(uint*) durations->At( durations_size + i ) = ( next_time > GameOpt.FullSecond ? next_time - GameOpt.FullSecond : 0 );
+            *(uint*) durations->At( durations_size + i ) = ( te.NextTime > GameOpt.FullSecond ? te.NextTime - GameOpt.FullSecond : 0 );
         }
         if( rates )
         {
-            *(uint*) rates->At( rates_size + i ) = *(uint*) te_rate->At( te_vec[ i ] );
+            *(uint*) rates->At( rates_size + i ) = te.Rate;
         }
     }
 
-    if( te_next_time )
-        te_next_time->Release();
-    if( te_rate )
-        te_rate->Release();
-
     return size;
 }
 
@@ -1610,25 +1610,19 @@ uint FOServer::SScriptFunc::Crit_GetTimeEventsArr( Critter* cr, CScriptArray* fi
     IntVec find_vec;
     Script::AssignScriptArrayInVector( find_vec, find_identifiers );
 
-    CScriptArray* te_identifier = cr->GetTE_Identifier();
-    UIntVec       te_vec;
-    for( uint i = 0, j = te_identifier->GetSize(); i < j; i++ )
+    CrTimeEventVec& time_events = cr->GetCrTimeEvents();
+    UIntVec         te_vec;
+    for( uint i = 0, j = (uint) time_events.size(); i < j; i++ )
     {
-        if( std::find( find_vec.begin(), find_vec.end(), *(int*) te_identifier->At( i ) ) != find_vec.end() )
+        if( std::find( find_vec.begin(), find_vec.end(), time_events[ i ].Identifier ) != find_vec.end() )
             te_vec.push_back( i );
     }
 
     uint size = (uint) te_vec.size();
     if( !size || ( !identifiers && !indexes && !durations && !rates ) )
-    {
-        te_identifier->Release();
         return size;
-    }
-
-    CScriptArray* te_next_time = nullptr;
-    CScriptArray* te_rate = nullptr;
 
-    uint          identifiers_size = 0, indexes_size = 0, durations_size = 0, rates_size = 0;
+    uint identifiers_size = 0, indexes_size = 0, durations_size = 0, rates_size = 0;
     if( identifiers )
     {
         identifiers_size = identifiers->GetSize();
@@ -1641,24 +1635,21 @@ uint FOServer::SScriptFunc::Crit_GetTimeEventsArr( Critter* cr, CScriptArray* fi
     }
     if( durations )
     {
-        te_next_time = cr->GetTE_NextTime();
-        RUNTIME_ASSERT( te_next_time->GetSize() == te_identifier->GetSize() );
         durations_size = durations->GetSize();
         durations->Resize( durations_size + size );
     }
     if( rates )
     {
-        te_rate = cr->GetTE_Rate();
-        RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
         rates_size = rates->GetSize();
         rates->Resize( rates_size + size );
     }
 
     for( uint i = 0; i < size; i++ )
     {
+        CrTimeEvent& te = time_events[ te_vec[ i ] ];
         if( identifiers )
         {
-            *(int*) identifiers->At( identifiers_size + i ) = *(uint*) te_identifier->At( te_vec[ i ] );
+            *(int*) identifiers->At( identifiers_size + i ) = te.Identifier;
         }
         if( indexes )
         {
@@ -1666,21 +1657,14 @@ uint FOServer::SScriptFunc::Crit_GetTimeEventsArr( Critter* cr, CScriptArray* fi
         }
         if( durations )
         {
-            uint next_time = *(uint*) te_next_time->At( te_vec[ i ] );
-            *(uint*) durations->At( durations_size + i ) = ( next_time > GameOpt.FullSecond ? next_time - GameOpt.FullSecond : 0 );
+            *(uint*) durations->At( durations_size + i ) = ( te.NextTime > GameOpt.FullSecond ? te.NextTime - GameOpt.FullSecond : 0 );
         }
         if( rates )
         {
-            *(uint*) rates->At( rates_size + i ) = *(uint*) te_rate->At( te_vec[ i ] );
+            *(uint*) rates->At( rates_size + i ) = te.Rate;
         }
     }
 
-    te_identifier->Release();
-    if( te_next_time )
-        te_next_time->Release();
-    if( te_rate )
-        te_rate->Release();
-
     return size;
 }
 
@@ -1689,20 +1673,12 @@ void FOServer::SScriptFunc::Crit_ChangeTimeEvent( Critter* cr, uint index, uint
     if( cr->IsDestroyed )
         SCRIPT_ERROR_R( "Attempt to call method on destroyed object." );
 
-    CScriptArray* te_func_num = cr->GetTE_FuncNum();
-    CScriptArray* te_identifier = cr->GetTE_Identifier();
-    RUNTIME_ASSERT( te_func_num->GetSize() == te_identifier->GetSize() );
-    if( index >= te_func_num->GetSize() )
-    {
-        te_func_num->Release();
-        te_identifier->Release();
+    CrTimeEventVec& time_events = cr->GetCrTimeEvents();
+    if( index >= time_events.size() )
         SCRIPT_ERROR_R( "Index arg is greater than maximum time events." );
-    }
 
-    hash func_num = *(hash*) te_func_num->At( index );
-    int  identifier = *(int*) te_identifier->At( index );
-    te_func_num->Release();
-    te_identifier->Release();
+    hash func_num = time_events[ index ].FuncNum;
+    int  identifier = time_events[ index ].Identifier;
 
     cr->EraseCrTimeEvent( index );
     cr->AddCrTimeEvent( func_num, new_rate, new_duration, identifier );
@@ -1713,10 +1689,7 @@ void FOServer::SScriptFunc::Crit_EraseTimeEvent( Critter* cr, uint index )
     if( cr->IsDestroyed )
         SCRIPT_ERROR_R( "Attempt to call method on destroyed object." );
 
-    CScriptArray* te_func_num = cr->GetTE_FuncNum();
-    uint          size = te_func_num->GetSize();
-    te_func_num->Release();
-    if( index >= size )
+    if( index >= cr->GetCrTimeEvents().size() )
         SCRIPT_ERROR_R( "Index arg is greater than maximum time events." );
 
     cr->EraseCrTimeEvent( index );
@@ -1727,42 +1700,7 @@ uint FOServer::SScriptFunc::Crit_EraseTimeEvents( Critter* cr, int identifier )
     if( cr->IsDestroyed )
         SCRIPT_ERROR_R0( "Attempt to call method on destroyed object." );
 
-    CScriptArray* te_next_time = cr->GetTE_NextTime();
-    CScriptArray* te_func_num = cr->GetTE_FuncNum();
-    CScriptArray* te_rate = cr->GetTE_Rate();
-    CScriptArray* te_identifier = cr->GetTE_Identifier();
-    RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
-    RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
-    RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
-
-    uint result = 0;
-    for( uint i = 0; i < te_identifier->GetSize();)
-    {
-        if( identifier == *(int*) te_identifier->At( i ) )
-        {
-            result++;
-            te_next_time->RemoveAt( i );
-            te_func_num->RemoveAt( i );
-            te_rate->RemoveAt( i );
-            te_identifier->RemoveAt( i );
-        }
-        else
-        {
-            i++;
-        }
-    }
-
-    cr->SetTE_NextTime( te_next_time );
-    cr->SetTE_FuncNum( te_func_num );
-    cr->SetTE_Rate( te_rate );
-    cr->SetTE_Identifier( te_identifier );
-
-    te_next_time->Release();
-    te_func_num->Release();
-    te_rate->Release();
-    te_identifier->Release();
-
-    return result;
+    return cr->EraseCrTimeEvents( { identifier } );
 }
 
 uint FOServer::SScriptFunc::Crit_EraseTimeEventsArr( Critter* cr, CScriptArray* identifiers )
@@ -1773,42 +1711,7 @@ uint FOServer::SScriptFunc::Crit_EraseTimeEventsArr( Critter* cr, CScriptArray*
     IntVec identifiers_;
     Script::AssignScriptArrayInVector( identifiers_, identifiers );
 
-    CScriptArray* te_next_time = cr->GetTE_NextTime();
-    CScriptArray* te_func_num = cr->GetTE_FuncNum();
-    CScriptArray* te_rate = cr->GetTE_Rate();
-    CScriptArray* te_identifier = cr->GetTE_Identifier();
-    RUNTIME_ASSERT( te_next_time->GetSize() == te_func_num->GetSize() );
-    RUNTIME_ASSERT( te_func_num->GetSize() == te_rate->GetSize() );
-    RUNTIME_ASSERT( te_rate->GetSize() == te_identifier->GetSize() );
-
-    uint result = 0;
-    for( uint i = 0; i < te_func_num->GetSize();)
-    {
-        if( std::find( identifiers_.begin(), identifiers_.end(), *(int*) te_identifier->At( i ) ) != identifiers_.end() )
-        {
-            result++;
-            te_next_time->RemoveAt( i );
-            te_func_num->RemoveAt( i );
-            te_rate->RemoveAt( i );
-            te_identifier->RemoveAt( i );
-        }
-        else
-        {
-            i++;
-        }
-    }
-
-    cr->SetTE_NextTime( te_next_time );
-    cr->SetTE_FuncNum( te_func_num );
-    cr->SetTE_Rate( te_rate );
-    cr->SetTE_Identifier( te_identifier );
-
-    te_next_time->Release();
-    te_func_num->Release();
-    te_rate->Release();
-    te_identifier->Release();
-
-    return result;
+    return cr->EraseCrTimeEvents( identifiers_ );
 }
 
 void FOServer::SScriptFunc::Crit_MoveToCritter( Critter* cr, Critter* target, uint cut, bool is_run )